@@ -1,5 +1,6 @@
 #include <openssl/rand.h>
 
+#include <cstring>
 #include <iostream>
 #include <span>
 
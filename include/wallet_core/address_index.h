@@ -0,0 +1,94 @@
+#ifndef WALLET_ADDRESS_INDEX_H
+#define WALLET_ADDRESS_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "tron.h"
+
+namespace wallet {
+class ExtendedKey;
+}
+
+namespace wallet::tron {
+
+/// Where an address sits below an account: m/44'/195'/account'/change/index.
+struct AddressPath {
+  uint32_t account;
+  uint32_t change;
+  uint32_t index;
+};
+
+/// Collects addresses and their paths, then writes them as an index file for
+/// `AddressIndex`.
+///
+/// The file holds the addresses sorted, a table of where each 16-bit prefix
+/// bucket starts, and the paths in the same order, all fixed-width little
+/// endian, so a reader can use it straight from a memory mapping.
+class AddressIndexBuilder {
+ public:
+  /// Derives the addresses `[start, start + count)` of `change` below the
+  /// account-level `key` and adds them under `account`.
+  ///
+  /// \throws std::invalid_argument if the range exceeds the non-hardened
+  /// index space.
+  void add_range(const ExtendedKey& key, uint32_t account, uint32_t change,
+                 uint32_t start, uint32_t count);
+  /// \throws std::invalid_argument if `address` lacks the 0x41 prefix.
+  void add(const TronAddress::Data& address, const AddressPath& path);
+  size_t size() const { return entries_.size(); }
+
+  /// Sorts the collected addresses and writes the index to `file`. If an
+  /// address was added more than once, the first path added is kept.
+  ///
+  /// \throws std::runtime_error if the file cannot be written.
+  void write(const std::string& file);
+
+ private:
+  struct Entry {
+    TronAddress::Data address;
+    AddressPath path;
+  };
+  std::vector<Entry> entries_;
+};
+
+/// Read-only view of an index file written by `AddressIndexBuilder`.
+///
+/// The file is memory-mapped rather than read, so opening it costs nothing
+/// beyond validating the header, and pages are loaded as lookups touch them.
+/// Lookups pick the address's prefix bucket and binary-search inside it.
+/// `find` may be called concurrently.
+class AddressIndex {
+ public:
+  /// \throws std::runtime_error if the file cannot be mapped or is not a
+  /// valid index.
+  explicit AddressIndex(const std::string& file);
+  AddressIndex(const AddressIndex&) = delete;
+  AddressIndex& operator=(const AddressIndex&) = delete;
+  AddressIndex(AddressIndex&& other) noexcept;
+  AddressIndex& operator=(AddressIndex&& other) noexcept;
+  ~AddressIndex();
+
+  size_t size() const { return count_; }
+  std::optional<AddressPath> find(const TronAddress::Data& address) const;
+
+ private:
+  void unmap();
+
+  const byte* base_ = nullptr;
+  size_t length_ = 0;
+  size_t count_ = 0;
+  const byte* buckets_ = nullptr;
+  const byte* addresses_ = nullptr;
+  const byte* paths_ = nullptr;
+#ifdef _WIN32
+  void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace wallet::tron
+
+#endif  // WALLET_ADDRESS_INDEX_H
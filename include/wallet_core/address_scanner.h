@@ -0,0 +1,71 @@
+#ifndef WALLET_ADDRESS_SCANNER_H
+#define WALLET_ADDRESS_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <span>
+#include <vector>
+
+#include "derivation_path.h"
+#include "tron.h"
+
+namespace wallet {
+class DerivationEngine;
+class ExtendedKey;
+
+/// Finds the used Tron addresses of an account with the BIP44 gap limit.
+///
+/// A chain is walked from index 0 and the walk stops once `gapLimit()`
+/// consecutive addresses are unused. Addresses are derived ahead in batches
+/// on the engine's workers, and the next batch is derived speculatively while
+/// the current one is being checked, so a slow "used" lookup and the
+/// derivation overlap instead of alternating.
+class AddressScanner {
+public:
+    /// Sets `used[i]` to whether `addresses[i]` has been used. Called with
+    /// consecutive addresses of one chain, one batch at a time, on one of the
+    /// engine's workers.
+    using UsedOracle = std::function<void(std::span<const tron::TronAddress::Data> addresses,
+                                          std::span<bool> used)>;
+
+    /// BIP44 gap limit.
+    static constexpr uint32_t DEFAULT_GAP_LIMIT = 20;
+
+    /// The first batch holds `gap_limit` addresses and each following one
+    /// twice as many, up to `batch`; 0 picks a size that keeps every worker
+    /// busy. `batch` is never less than `gap_limit`.
+    explicit AddressScanner(DerivationEngine& engine, uint32_t gap_limit = DEFAULT_GAP_LIMIT,
+                            size_t batch = 0);
+
+    uint32_t gapLimit() const { return gap_limit_; }
+    size_t batchSize() const { return batch_; }
+
+    /// Indices of the used addresses on `change` below the account-level
+    /// `key`, in ascending order.
+    ///
+    /// \throws std::invalid_argument if `change` is hardened, and whatever
+    /// `used` throws.
+    std::vector<uint32_t> scanChain(const ExtendedKey& key, uint32_t change,
+                                    const UsedOracle& used) const;
+    /// Same as above, with the used addresses given as a set.
+    std::vector<uint32_t> scanChain(const ExtendedKey& key, uint32_t change,
+                                    const std::set<tron::TronAddress::Data>& used) const;
+
+    /// Scans the receive (0) and change (1) chains of `account` and returns
+    /// the used paths as m/44'/195'/account'/change/index.
+    std::vector<DerivationPath> scanAccount(const ExtendedKey& key, uint32_t account,
+                                            const UsedOracle& used) const;
+    std::vector<DerivationPath> scanAccount(const ExtendedKey& key, uint32_t account,
+                                            const std::set<tron::TronAddress::Data>& used) const;
+
+private:
+    DerivationEngine& engine_;
+    uint32_t gap_limit_;
+    size_t batch_;
+};
+
+}  // namespace wallet
+
+#endif  // WALLET_ADDRESS_SCANNER_H
@@ -0,0 +1,69 @@
+#ifndef WALLET_BATCH_SIGNER_H
+#define WALLET_BATCH_SIGNER_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+#include "base.h"
+#include "private_key.h"
+#include "tron.h"
+
+namespace wallet {
+class ThreadPool;
+
+/// Signs many digests or Tron transactions, or recovers their signers, at
+/// once on a fixed pool of worker threads.
+///
+/// The work is split into chunks that the workers balance by work stealing.
+/// Each worker signs with its own secp256k1 context and writes straight into
+/// the output, so no signature allocates. Every call blocks until the whole
+/// batch is done and writes signature `i` to `out[i]`. A single signer may
+/// be used from several threads at once.
+class BatchSigner {
+public:
+    using Hash = std::array<byte, 32>;
+
+    /// Starts `threads` workers; 0 means one per hardware thread.
+    explicit BatchSigner(size_t threads = 0);
+    BatchSigner(const BatchSigner&) = delete;
+    BatchSigner& operator=(const BatchSigner&) = delete;
+    ~BatchSigner();
+
+    size_t threads() const;
+
+    /// `out[i] = keys[i].signRecoverable(hashes[i])`.
+    ///
+    /// \throws std::invalid_argument if the spans differ in size.
+    /// \throws std::runtime_error if a key is not a valid secret key.
+    void sign(std::span<const PrivateKey> keys, std::span<const Hash> hashes,
+              std::span<PrivateKey::Signature> out);
+    /// Signs every hash with the same `key`.
+    void sign(const PrivateKey& key, std::span<const Hash> hashes,
+              std::span<PrivateKey::Signature> out);
+
+    /// Signs Tron transactions given as their serialized `raw_data`: the
+    /// digest is the SHA-256 of each, computed on the workers as well.
+    void signTransactions(std::span<const PrivateKey> keys,
+                          std::span<const std::span<const byte>> raw_data,
+                          std::span<PrivateKey::Signature> out);
+    void signTransactions(const PrivateKey& key, std::span<const std::span<const byte>> raw_data,
+                          std::span<PrivateKey::Signature> out);
+
+    /// Parallel `tron::TronAddress::recover_addresses`: writes the address
+    /// that signed `hashes[i]` with `sigs[i]` to `out[i]` and whether the
+    /// signature is recoverable to `valid[i]`. Returns the number of valid
+    /// signatures.
+    ///
+    /// \throws std::invalid_argument if the spans differ in size.
+    size_t recoverAddresses(std::span<const PrivateKey::Signature> sigs, std::span<const Hash> hashes,
+                            std::span<tron::TronAddress::Data> out, std::span<bool> valid);
+
+private:
+    std::unique_ptr<ThreadPool> pool_;
+};
+
+}  // namespace wallet
+
+#endif  // WALLET_BATCH_SIGNER_H
@@ -0,0 +1,67 @@
+#ifndef WALLET_DERIVATION_ENGINE_H
+#define WALLET_DERIVATION_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "base.h"
+#include "hd_wallet.h"
+#include "private_key.h"
+#include "public_key.h"
+#include "tron.h"
+
+namespace wallet {
+struct DerivationPath;
+class ExtendedKey;
+class ThreadPool;
+
+/// Runs bulk derivations on a fixed pool of worker threads.
+///
+/// Large index ranges and seed lists are split into chunks that the workers
+/// balance between themselves by work stealing. Every call blocks until the
+/// whole job is done and writes result `i` to `out[i]`, so the output order
+/// never depends on scheduling. A single engine may be used from several
+/// threads at once.
+class DerivationEngine {
+public:
+    /// Starts `threads` workers; 0 means one per hardware thread.
+    explicit DerivationEngine(size_t threads = 0);
+    DerivationEngine(const DerivationEngine&) = delete;
+    DerivationEngine& operator=(const DerivationEngine&) = delete;
+    ~DerivationEngine();
+
+    size_t threads() const;
+
+    /// Parallel `HDWallet::deriveRange`.
+    void deriveRange(const std::string& extended, uint32_t change, uint32_t start,
+                     std::span<PublicKey::KeyData> out);
+    /// Parallel `HDWallet::deriveTronAddressRange`.
+    void deriveTronAddressRange(const std::string& extended, uint32_t change, uint32_t start,
+                                std::span<tron::TronAddress::Data> out);
+    /// Parallel `ExtendedKey::deriveRange`.
+    void deriveRange(const ExtendedKey& key, uint32_t change, uint32_t start,
+                     std::span<PublicKey::KeyData> out);
+    /// Parallel `ExtendedKey::deriveTronAddressRange`.
+    void deriveTronAddressRange(const ExtendedKey& key, uint32_t change, uint32_t start,
+                                std::span<tron::TronAddress::Data> out);
+
+    /// Derives the private key at `path` from each seed: `out[i]` is the key
+    /// of `seeds[i]`.
+    void deriveKeys(std::span<const HDWallet::SeedData> seeds, const DerivationPath& path,
+                    std::span<PrivateKey::KeyData> out);
+    /// Derives the Tron address at `path` from each seed.
+    void deriveTronAddresses(std::span<const HDWallet::SeedData> seeds, const DerivationPath& path,
+                             std::span<tron::TronAddress::Data> out);
+
+private:
+    friend class AddressScanner;
+
+    std::unique_ptr<ThreadPool> pool_;
+};
+
+}  // namespace wallet
+
+#endif  // WALLET_DERIVATION_ENGINE_H
@@ -1,24 +1,43 @@
 #ifndef WALLET_DERIVATION_PATH
 #define WALLET_DERIVATION_PATH
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "prevector.h"
+
 namespace wallet {
 
 enum class Purpose {
     BIP44 = 44,
 };
 
+/// Why `DerivationPath::parse` rejected a string.
+enum class DerivationPathError {
+    None,
+    /// A component does not start with a decimal digit.
+    InvalidComponent,
+    /// A component is followed by something other than `'`, `/` or the end.
+    MissingSeparator,
+    /// A component is 2^31 or more, which would collide with the hardened
+    /// indices.
+    IndexOutOfRange,
+};
+
 struct DerivationPathIndex {
     uint32_t value;
     bool hardened;
     DerivationPathIndex() = default;
-    DerivationPathIndex(uint32_t value, bool hardened = true)
+    constexpr DerivationPathIndex(uint32_t value, bool hardened = true)
         :value(value),hardened(hardened) {}
     
-    uint32_t derivationIndex() const {
+    constexpr uint32_t derivationIndex() const {
         if (hardened) {
             return value | 0x80000000;
         } else {
@@ -35,8 +54,59 @@ struct DerivationPathIndex {
     }
 };
 
+namespace detail {
+/// Parses a string description like `m/10/0/2'/3` and calls `emit` with each
+/// component in order. Shared by the runtime parser and the `_path` literal.
+template <typename Emit>
+constexpr DerivationPathError parseDerivationPath(std::string_view string, Emit&& emit) {
+    auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+    const auto* it = string.data();
+    const auto* end = string.data() + string.size();
+
+    if (it != end && *it == 'm') {
+        ++it;
+    }
+    if (it != end && *it == '/') {
+        ++it;
+    }
+
+    while (it != end) {
+        if (!is_digit(*it)) {
+            return DerivationPathError::InvalidComponent;
+        }
+        uint64_t value = 0;
+        do {
+            value = value * 10 + static_cast<uint64_t>(*it - '0');
+            if (value >= 0x80000000) {
+                return DerivationPathError::IndexOutOfRange;
+            }
+            ++it;
+        } while (it != end && is_digit(*it));
+
+        auto hardened = (it != end && *it == '\'');
+        if (hardened) {
+            ++it;
+        }
+        emit(DerivationPathIndex(static_cast<uint32_t>(value), hardened));
+
+        if (it == end) {
+            break;
+        }
+        if (*it != '/') {
+            return DerivationPathError::MissingSeparator;
+        }
+        ++it;
+    }
+    return DerivationPathError::None;
+}
+}  // namespace detail
+
 struct DerivationPath {
-    std::vector<DerivationPathIndex> indices;
+    /// Depth up to which the indices are stored inline, without allocating.
+    static constexpr unsigned int INLINE_DEPTH = 10;
+    using Indices = prevector<INLINE_DEPTH, DerivationPathIndex>;
+
+    Indices indices;
     Purpose purpose() const {
         if (indices.size() == 0) {
             return Purpose::BIP44;
@@ -110,14 +180,16 @@ struct DerivationPath {
 
     DerivationPath() = default;
     explicit DerivationPath(std::initializer_list<DerivationPathIndex> l)
-        : indices(l) {}
-    explicit DerivationPath(std::vector<DerivationPathIndex> indices)
-        : indices(std::move(indices)) {}
+        : indices(l.begin(), l.end()) {}
+    explicit DerivationPath(std::span<const DerivationPathIndex> indices)
+        : indices(indices.begin(), indices.end()) {}
+    explicit DerivationPath(const std::vector<DerivationPathIndex>& indices)
+        : indices(indices.begin(), indices.end()) {}
 
     /// Creates a `DerivationPath` by BIP44 components.
     DerivationPath(Purpose purpose, uint32_t coin, uint32_t account, uint32_t change,
                    uint32_t address)
-        : indices(std::vector<DerivationPathIndex>(5)) {
+        : indices(5) {
         setPurpose(purpose);
         setCoin(coin);
         setAccount(account);
@@ -129,13 +201,98 @@ struct DerivationPath {
     ///
     /// \throws std::invalid_argument if the string is not a valid derivation
     /// path.
-    explicit DerivationPath(const std::string& string);
+    explicit DerivationPath(std::string_view string);
+
+    /// Parses a string description like `m/10/0/2'/3` into `path`. Leaves
+    /// `path` unchanged if the string is invalid.
+    static DerivationPathError parse(std::string_view string, DerivationPath& path) noexcept;
+
+    /// Checks a string description without building the path.
+    static constexpr DerivationPathError validate(std::string_view string) {
+        return detail::parseDerivationPath(string, [](DerivationPathIndex) {});
+    }
+
+    /// Length of the longest string representation of a path `depth` deep.
+    static constexpr size_t maxStringSize(size_t depth) {
+        // "m" 加上每层最多 "/2147483647'"
+        return 1 + depth * 12;
+    }
+
+    /// Writes the string representation to `out`, without a terminating NUL,
+    /// and returns its length. Returns 0 if `out` is shorter than
+    /// `maxStringSize(indices.size())`.
+    size_t format(std::span<char> out) const noexcept;
 
     /// String representation.
     std::string string() const noexcept;
 
 };
 
+/// A derivation path of fixed depth `N`, usable in constant expressions.
+///
+/// Usually made by the `_path` literal. Converts to `DerivationPath` without
+/// parsing, and without allocating up to `DerivationPath::INLINE_DEPTH`.
+template <size_t N>
+struct StaticDerivationPath {
+    std::array<DerivationPathIndex, N> indices{};
+
+    static constexpr size_t depth() { return N; }
+
+    /// The path one level deeper, e.g. an address below a change template.
+    constexpr StaticDerivationPath<N + 1> child(uint32_t value, bool hardened = false) const {
+        StaticDerivationPath<N + 1> path;
+        for (size_t i = 0; i < N; ++i) {
+            path.indices[i] = indices[i];
+        }
+        path.indices[N] = DerivationPathIndex(value, hardened);
+        return path;
+    }
+
+    operator DerivationPath() const {
+        return DerivationPath(std::span<const DerivationPathIndex>(indices));
+    }
+};
+
+namespace detail {
+template <size_t N>
+struct DerivationPathLiteral {
+    // 每层至少占一个字符，层数不会超过字符串长度
+    std::array<DerivationPathIndex, N> indices{};
+    size_t depth = 0;
+
+    consteval DerivationPathLiteral(const char (&string)[N]) {
+        if (string[N - 1]) throw "null terminator required";
+        const auto error = parseDerivationPath(std::string_view(string, N - 1),
+                                               [this](DerivationPathIndex index) {
+                                                   indices[depth++] = index;
+                                               });
+        switch (error) {
+        case DerivationPathError::None:
+            break;
+        case DerivationPathError::InvalidComponent:
+            throw "Invalid component";
+        case DerivationPathError::MissingSeparator:
+            throw "Components should be separated by '/'";
+        case DerivationPathError::IndexOutOfRange:
+            throw "Component is out of range";
+        }
+    }
+};
+}  // namespace detail
+
+inline namespace path_literals {
+/// `"m/44'/195'/0'/0"_path` is a `StaticDerivationPath` parsed and validated
+/// at compile time; an invalid path does not compile.
+template <detail::DerivationPathLiteral string>
+consteval auto operator""_path() {
+    StaticDerivationPath<string.depth> path;
+    for (size_t i = 0; i < string.depth; ++i) {
+        path.indices[i] = string.indices[i];
+    }
+    return path;
+}
+}  // inline namespace path_literals
+
 }
 
 #endif // WALLET_DERIVATION_PATH
\ No newline at end of file
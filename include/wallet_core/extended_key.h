@@ -0,0 +1,71 @@
+#ifndef WALLET_EXTENDED_KEY_H
+#define WALLET_EXTENDED_KEY_H
+
+#include <memory>
+#include <span>
+#include <string>
+
+#include "base.h"
+#include "public_key.h"
+#include "private_key.h"
+#include "tron.h"
+
+namespace wallet {
+struct DerivationPath;
+
+/// A decoded BIP32 extended key (`xpub` or `xprv`).
+///
+/// The Base58Check decoding, version check and public key parsing happen
+/// once in `parse`; the key can then be derived from any number of times.
+/// The change-level nodes of the usual receive and change chains (0 and 1)
+/// are derived on first use and kept, so each address costs a single level.
+///
+/// Copies share the decoded state, and all methods may be called
+/// concurrently.
+class ExtendedKey {
+public:
+    /// \throws std::runtime_error if `extended` is not a valid extended key.
+    static ExtendedKey parse(const std::string& extended);
+
+    bool isPrivate() const;
+    /// Encodes the key again, as given.
+    std::string serialize() const;
+    /// Encodes the public half of the key as an `xpub`.
+    std::string serializePublic() const;
+
+    /// The child key at `index`.
+    ///
+    /// \throws std::runtime_error if `index` is hardened and the key is
+    /// public.
+    ExtendedKey derive(uint32_t index) const;
+
+    /// Public key at the change/address levels of `path` below this
+    /// account-level key.
+    PublicKey derivePublicKey(const DerivationPath& path) const;
+    /// Private key at the change/address levels of `path`.
+    ///
+    /// \throws std::runtime_error if the key is public.
+    PrivateKey derivePrivateKey(const DerivationPath& path) const;
+    /// Tron address at the change/address levels of `path`.
+    tron::TronAddress deriveTronAddress(const DerivationPath& path) const;
+
+    /// Derives the compressed public keys of the consecutive addresses
+    /// `start, start + 1, ..., start + out.size() - 1` under `change`.
+    ///
+    /// \throws std::invalid_argument if the range exceeds the non-hardened
+    /// index space.
+    void deriveRange(uint32_t change, uint32_t start, std::span<PublicKey::KeyData> out) const;
+    /// Same as `deriveRange`, but writes the Tron address of each key.
+    void deriveTronAddressRange(uint32_t change, uint32_t start,
+                                std::span<tron::TronAddress::Data> out) const;
+
+private:
+    struct Impl;
+    explicit ExtendedKey(std::shared_ptr<const Impl> impl);
+
+    std::shared_ptr<const Impl> impl_;
+};
+
+} // namespace wallet
+
+#endif // WALLET_EXTENDED_KEY_H
@@ -4,34 +4,68 @@
 #include <vector>
 #include <string>
 #include <array>
+#include <memory>
 #include <optional>
+#include <span>
 
 #include "base.h"
 #include "public_key.h"
 #include "private_key.h"
+#include "tron.h"
 #include "secp256k1.h"
 
 namespace wallet {
 struct DerivationPath;
+struct HDNode;
+class NodeCache;
 class HDWallet {
+public:
     using SeedData = std::array<byte, 64>;
 private:
     SeedData seed_;
+    /// Intermediate nodes of previously derived paths, so sibling
+    /// derivations only redo the levels that differ. Copies start with an
+    /// empty cache; a moved-from wallet derives without one.
+    std::unique_ptr<NodeCache> cache_;
+    HDNode deriveNode(const DerivationPath& path) const;
 public:
     HDWallet(const std::vector<byte> &seeds);
     HDWallet(const SeedData &seeds);
-    HDWallet(const HDWallet& other) = default;
-    HDWallet(HDWallet&& other) = default;
-    HDWallet& operator=(const HDWallet& other) = default;
-    HDWallet& operator=(HDWallet&& other) = default;
-    ~HDWallet() = default;
+    HDWallet(const HDWallet& other);
+    HDWallet(HDWallet&& other) noexcept;
+    HDWallet& operator=(const HDWallet& other);
+    HDWallet& operator=(HDWallet&& other) noexcept;
+    ~HDWallet();
     const SeedData& getSeed() const;
     PrivateKey getRootKey() const;
     PrivateKey getKey(const DerivationPath& path) const;
+    /// Tron address of the key at `path`, hashed from the derived point
+    /// without a compressed round trip.
+    tron::TronAddress getTronAddress(const DerivationPath& path) const;
     std::string getExtendedPublicKeyAccount(uint32_t coin, uint32_t account) const;
     std::string getExtendedPrivateKeyAccount(uint32_t coin, uint32_t account) const;
+    /// The `...FromExtended` functions and the ranges below decode
+    /// `extended` on every call; keep an `ExtendedKey` instead when deriving
+    /// repeatedly from the same key.
     static PrivateKey getPrivateKeyFromExtended(const std::string& extended, const DerivationPath& path);
     static PublicKey getPublicKeyFromExtended(const std::string& extended, const DerivationPath& path);
+    /// Tron address of the key at the change/address levels of `path` below
+    /// an account-level extended key.
+    static tron::TronAddress getTronAddressFromExtended(const std::string& extended, const DerivationPath& path);
+
+    /// Derives the compressed public keys of the consecutive addresses
+    /// `start, start + 1, ..., start + out.size() - 1` under `change` from an
+    /// account-level extended key, writing them into `out` in order.
+    ///
+    /// The change node is derived only once for the whole range.
+    ///
+    /// \throws std::invalid_argument if the range exceeds the non-hardened
+    /// index space.
+    static void deriveRange(const std::string& extended, uint32_t change, uint32_t start,
+                            std::span<PublicKey::KeyData> out);
+    /// Same as `deriveRange`, but writes the Tron address of each key.
+    static void deriveTronAddressRange(const std::string& extended, uint32_t change, uint32_t start,
+                                       std::span<tron::TronAddress::Data> out);
 };
 
 } // namespace wallet
@@ -0,0 +1,31 @@
+#ifndef WALLET_INIT_H
+#define WALLET_INIT_H
+
+#include <cstddef>
+
+namespace wallet {
+
+/// Sets up the secp256k1 contexts used by every key operation.
+///
+/// `contexts` contexts are created up front in one preallocated arena, and
+/// each thread that touches a key borrows one of them for its lifetime.
+/// Threads beyond that number get a context of their own. 0 picks a number
+/// based on the hardware concurrency. Every borrowed context is randomized
+/// with fresh OS entropy when handed out and again periodically while in
+/// use, so blinding never depends on a context shared between threads.
+///
+/// Calling `init` is optional: the first key operation sets up the default
+/// configuration. Calling it again before `shutdown` has no effect.
+///
+/// \throws std::runtime_error if the operating system provides no entropy.
+void init(size_t contexts = 0);
+
+/// Destroys the contexts created by `init` and wipes their memory.
+///
+/// No key operation may be running on any thread. Threads that later use
+/// the library again borrow contexts from a new, implicitly set up arena.
+void shutdown();
+
+}  // namespace wallet
+
+#endif  // WALLET_INIT_H
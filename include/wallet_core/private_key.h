@@ -2,18 +2,30 @@
 #define WALLET_PRIVATE_KEY_H
 
 #include "base.h"
+#include <array>
+#include <span>
 #include <vector>
 #include "public_key.h"
 #include "secp256k1.h"
 
 namespace wallet {
 class PrivateKey {
-using KeyData = std::array<byte,32>;
+public:
+    using KeyData = std::array<byte,32>;
+    /// Recoverable signature as Tron encodes it: r || s || v, where v is the
+    /// recovery id plus 27.
+    using Signature = std::array<byte,65>;
 private:
     KeyData data_;
 public:
     PrivateKey(const KeyData& data);
     PublicKey getPublicKey() const;
+    /// Signs a 32-byte digest (for a Tron transaction, the SHA-256 of its
+    /// raw data) with a deterministic RFC 6979 nonce. `s` is always in the
+    /// lower half of the order.
+    ///
+    /// \throws std::runtime_error if the key is not a valid secret key.
+    Signature signRecoverable(std::span<const byte, 32> hash) const;
     const KeyData& data() const;
 };
 }
@@ -11,7 +11,8 @@
 namespace wallet {
 
 class PublicKey {
-using KeyData = std::array<byte, 33>;
+public:
+    using KeyData = std::array<byte, 33>;
 private:
     KeyData data_;
 public:
@@ -3,26 +3,79 @@
 
 #include "base.h"
 #include <array>
+#include <span>
 #include <string>
+#include <string_view>
 #include "secp256k1.h"
 
 namespace wallet {
     class PublicKey;
+    class PrivateKey;
 }
 
 namespace wallet::tron {
 
 class TronAddress {
+ public:
   using Data = std::array<byte, 21>;
+  /// Length of the Base58Check form of an address.
+  static constexpr size_t STRING_SIZE = 34;
 
  private:
   Data data_;
 
  public:
   TronAddress(const Data& data);
+  const Data& data() const;
   std::string string();
+  /// Writes the Base58Check form into `out` without allocating.
+  ///
+  /// \throws std::runtime_error if the data does not encode to exactly
+  /// `STRING_SIZE` characters, i.e. is not a Tron address.
+  void string(std::span<char, STRING_SIZE> out) const;
   std::string hex();
+  /// Parses a Base58Check address.
+  ///
+  /// \throws std::invalid_argument if `str` is not a valid Tron address.
+  static TronAddress from_string(std::string_view str);
+  /// Whether `str` is a valid Base58Check Tron address, without allocating.
+  static bool is_valid(std::string_view str);
+  /// Batch `string`: writes the Base58Check form of `data[i]` to `out[i]`,
+  /// hashing the checksums several at a time.
+  ///
+  /// \throws std::invalid_argument if the spans differ in size.
+  /// \throws std::runtime_error if some data is not a Tron address.
+  static void to_strings(std::span<const Data> data,
+                         std::span<std::array<char, STRING_SIZE>> out);
+  /// Batch `is_valid`: sets `valid[i]` to whether `strs[i]` is a Tron
+  /// address and, if so, writes its data to `out[i]`. Returns the number of
+  /// valid addresses.
+  ///
+  /// \throws std::invalid_argument if the spans differ in size.
+  static size_t validate(std::span<const std::string_view> strs,
+                         std::span<Data> out, std::span<bool> valid);
   static TronAddress derive_from_public_key(const PublicKey& key);
+  /// Derives the address of `key`'s public key straight from the computed
+  /// point, without compressing it and parsing it back.
+  static TronAddress derive_from_private_key(const PrivateKey& key);
+  /// Derives the address of an already parsed public key. Unlike the
+  /// compressed form, this needs no square root to recover the point.
+  static TronAddress derive_from_point(const secp256k1_pubkey& key);
+  /// Batch `derive_from_point`: writes the address of `keys[i]` to `out[i]`,
+  /// hashing several keys at once with the multi-buffer Keccak.
+  ///
+  /// \throws std::invalid_argument if the spans differ in size.
+  static void derive_from_points(std::span<const secp256k1_pubkey> keys, std::span<Data> out);
+  /// Recovers the signer of each `sigs[i]` over `hashes[i]` (r || s || v, v
+  /// being the recovery id or the id plus 27) and writes its address to
+  /// `out[i]`. The recovered points are hashed as they are, without being
+  /// serialized and parsed back. Sets `valid[i]` to whether the signature
+  /// recovers to a key and returns the number that do.
+  ///
+  /// \throws std::invalid_argument if the spans differ in size.
+  static size_t recover_addresses(std::span<const std::array<byte, 65>> sigs,
+                                  std::span<const std::array<byte, 32>> hashes,
+                                  std::span<Data> out, std::span<bool> valid);
 };
 }  // namespace wallet::tron
 
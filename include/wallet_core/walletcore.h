@@ -6,6 +6,12 @@
 #include "public_key.h"
 #include "private_key.h"
 #include "hd_wallet.h"
+#include "extended_key.h"
+#include "derivation_engine.h"
 #include "tron.h"
+#include "address_index.h"
+#include "address_scanner.h"
+#include "batch_signer.h"
+#include "init.h"
 
 #endif // WALLET_WALLETCORE_H
\ No newline at end of file
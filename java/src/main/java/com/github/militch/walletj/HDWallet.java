@@ -1,36 +1,80 @@
 package com.github.militch.walletj;
 
+import java.lang.ref.Cleaner;
+import java.lang.ref.Reference;
+import java.nio.BufferOverflowException;
+import java.nio.ByteBuffer;
+import java.nio.ReadOnlyBufferException;
 import java.security.SecureRandom;
+import java.util.Arrays;
+import java.util.concurrent.CompletableFuture;
 
 /**
  * 这个类提供了分层确定性钱包相关操作方法的实现
  * <p>
  * 关于分层确定性钱包的定义参阅 <a href="https://en.bitcoin.it/wiki/BIP_0032">BIP 0032 - Bitcoin Wiki</a>
  * <p/>
+ * 每个实例持有一个原生钱包对象，其中缓存了已派生的中间节点，重复派生同一账户下的地址时不必从主密钥重新计算。
+ * 使用完毕后应调用 {@link #close()} 擦除并释放原生内存；未关闭的实例会在被回收时释放。
+ * 实例的方法可以被多个线程同时调用，但不能与 {@link #close()} 并发调用。
+ * <p/>
  * 使用示例:
  * <pre>
- * HDWallet hdWallet = new HDWallet();
- * String address = hdWallet.getTronAddress("m/44'/195'/0'/0/0");
+ * try (HDWallet hdWallet = new HDWallet()) {
+ *     String address = hdWallet.getTronAddress(0, 0, 0);
+ * }
  * <pre>
  */
-public final class HDWallet {
+public final class HDWallet implements AutoCloseable {
     static {
         loadLibrary();
     }
     private final static int SEED_LEN = 64;
+    /**
+     * 批量接口中每个TRON地址记录的字节数，即 Base58 地址的长度
+     */
+    public static final int TRON_ADDRESS_RECORD_SIZE = 34;
+    /**
+     * 批量接口中每个压缩公钥记录的字节数
+     */
+    public static final int PUBLIC_KEY_RECORD_SIZE = 33;
     private static final SecureRandom secureRandom = new SecureRandom();
-    private final byte[] seed;
+    private static final Cleaner cleaner = Cleaner.create();
+
+    /**
+     * 原生对象的句柄，关闭后为 0
+     */
+    private static final class NativeHandle implements Runnable {
+        private volatile long value;
+
+        NativeHandle(long value) {
+            this.value = value;
+        }
+
+        @Override
+        public synchronized void run() {
+            long handle = value;
+            value = 0;
+            if (handle != 0) {
+                destroy(handle);
+            }
+        }
+    }
+
+    private final NativeHandle handle;
+    private final Cleaner.Cleanable cleanable;
 
     private static void loadLibrary() {
         NativeLibraryLoader.load("walletcore", HDWallet.class.getClassLoader());
     }
 
     /**
-     * 使用随机种子构造
-     * @param seed 随机种子
+     * 使用随机种子构造，种子会被复制到原生内存中
+     * @param seed 随机种子，长度为 64 字节
      */
     public HDWallet(byte[] seed) {
-        this.seed = seed;
+        this.handle = new NativeHandle(create(seed));
+        this.cleanable = cleaner.register(this, handle);
     }
 
     /**
@@ -39,7 +83,25 @@ public final class HDWallet {
     public HDWallet() {
         byte[] seed = new byte[SEED_LEN];
         secureRandom.nextBytes(seed);
-        this.seed = seed;
+        this.handle = new NativeHandle(create(seed));
+        this.cleanable = cleaner.register(this, handle);
+        Arrays.fill(seed, (byte) 0);
+    }
+
+    private long handle() {
+        long value = handle.value;
+        if (value == 0) {
+            throw new IllegalStateException("HDWallet is closed");
+        }
+        return value;
+    }
+
+    /**
+     * 擦除并释放原生钱包对象，重复调用没有影响
+     */
+    @Override
+    public void close() {
+        cleanable.clean();
     }
 
     /**
@@ -49,7 +111,28 @@ public final class HDWallet {
      * @return 私钥
      */
     public byte[] getPrivateKey(String path) {
-        return getPrivateKeyFromSeedWithPath(seed, path);
+        try {
+            return getPrivateKey0(handle(), path);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+    }
+
+    /**
+     * 返回 BIP44 路径 m/44'/coin'/account'/change/index 的私钥，不需要解析路径字符串
+     *
+     * @param coin    币种
+     * @param account 账户
+     * @param change  0 为收款地址，1 为找零地址
+     * @param index   地址序号
+     * @return 私钥
+     */
+    public byte[] getPrivateKey(CoinType coin, int account, int change, int index) {
+        try {
+            return getPrivateKeyAt(handle(), coin.getId(), account, change, index);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
     }
 
     /**
@@ -59,7 +142,28 @@ public final class HDWallet {
      * @return 公钥
      */
     public byte[] getPublicKey(String path) {
-        return getPublicKeyFromSeedWithPath(seed, path);
+        try {
+            return getPublicKey0(handle(), path);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+    }
+
+    /**
+     * 返回 BIP44 路径 m/44'/coin'/account'/change/index 的公钥
+     *
+     * @param coin    币种
+     * @param account 账户
+     * @param change  0 为收款地址，1 为找零地址
+     * @param index   地址序号
+     * @return 公钥
+     */
+    public byte[] getPublicKey(CoinType coin, int account, int change, int index) {
+        try {
+            return getPublicKeyAt(handle(), coin.getId(), account, change, index);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
     }
 
     /**
@@ -69,7 +173,151 @@ public final class HDWallet {
      * @return 地址
      */
     public String getTronAddress(String path) {
-        return getTronAddressFromSeed(seed, path);
+        try {
+            return getTronAddress0(handle(), path);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+    }
+
+    /**
+     * 返回 BIP44 路径 m/44'/195'/account'/change/index 的TRON地址
+     *
+     * @param account 账户
+     * @param change  0 为收款地址，1 为找零地址
+     * @param index   地址序号
+     * @return 地址
+     */
+    public String getTronAddress(int account, int change, int index) {
+        try {
+            return getTronAddressAt(handle(), account, change, index);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+    }
+
+    /**
+     * 批量派生 m/44'/195'/account'/change/index 的TRON地址，index 从 start 到 start + count - 1
+     * <p>
+     * 地址以 {@link #TRON_ADDRESS_RECORD_SIZE} 字节的 ASCII 记录依次写入 out 的当前位置，
+     * 写入后 out 的位置向后移动。整个批次只有一次 JNI 调用，不会为每个地址创建 Java 对象。
+     *
+     * @param account 账户
+     * @param change  0 为收款地址，1 为找零地址
+     * @param start   起始地址序号
+     * @param count   地址数量
+     * @param out     直接缓冲区，剩余空间至少为 count * {@link #TRON_ADDRESS_RECORD_SIZE}
+     */
+    public void getTronAddresses(int account, int change, int start, int count, ByteBuffer out) {
+        int offset = checkRecords(out, count, TRON_ADDRESS_RECORD_SIZE);
+        try {
+            getTronAddresses0(handle(), account, change, start, count, out, offset);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+        out.position(offset + count * TRON_ADDRESS_RECORD_SIZE);
+    }
+
+    /**
+     * 批量派生 m/44'/coin'/account'/change/index 的压缩公钥，写入方式同 {@link #getTronAddresses}
+     *
+     * @param coin    币种
+     * @param account 账户
+     * @param change  0 为收款地址，1 为找零地址
+     * @param start   起始地址序号
+     * @param count   公钥数量
+     * @param out     直接缓冲区，剩余空间至少为 count * {@link #PUBLIC_KEY_RECORD_SIZE}
+     */
+    public void getPublicKeys(CoinType coin, int account, int change, int start, int count, ByteBuffer out) {
+        int offset = checkRecords(out, count, PUBLIC_KEY_RECORD_SIZE);
+        try {
+            getPublicKeys0(handle(), coin.getId(), account, change, start, count, out, offset);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+        out.position(offset + count * PUBLIC_KEY_RECORD_SIZE);
+    }
+
+    /**
+     * 在原生线程池中派生 m/44'/195'/account'/change/index 的TRON地址，调用线程不会阻塞
+     * <p>
+     * 返回的 future 在原生工作线程上完成，依赖它的同步回调也在该线程上执行，耗时的回调应使用 *Async 方法切换线程。
+     * 派生开始后关闭钱包不会影响已提交的任务。
+     *
+     * @param account 账户
+     * @param change  0 为收款地址，1 为找零地址
+     * @param index   地址序号
+     * @return 完成时为地址
+     */
+    public CompletableFuture<String> getTronAddressAsync(int account, int change, int index) {
+        CompletableFuture<String> future = new CompletableFuture<>();
+        try {
+            getTronAddressAsync0(handle(), account, change, index, future);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+        return future;
+    }
+
+    /**
+     * {@link #getTronAddresses} 的异步版本，在原生线程池中派生并写入 out
+     * <p>
+     * 地址写入调用时 out 的当前位置，out 的位置不会改变；future 完成之前不要读写这段区域。
+     *
+     * @param account 账户
+     * @param change  0 为收款地址，1 为找零地址
+     * @param start   起始地址序号
+     * @param count   地址数量
+     * @param out     直接缓冲区，剩余空间至少为 count * {@link #TRON_ADDRESS_RECORD_SIZE}
+     * @return 写入完成时为 out
+     */
+    public CompletableFuture<ByteBuffer> getTronAddressesAsync(int account, int change, int start, int count, ByteBuffer out) {
+        int offset = checkRecords(out, count, TRON_ADDRESS_RECORD_SIZE);
+        CompletableFuture<Void> done = new CompletableFuture<>();
+        try {
+            getTronAddressesAsync0(handle(), account, change, start, count, out, offset, done);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+        return done.thenApply(ignored -> out);
+    }
+
+    /**
+     * {@link #getPublicKeys} 的异步版本，写入方式同 {@link #getTronAddressesAsync}
+     *
+     * @param coin    币种
+     * @param account 账户
+     * @param change  0 为收款地址，1 为找零地址
+     * @param start   起始地址序号
+     * @param count   公钥数量
+     * @param out     直接缓冲区，剩余空间至少为 count * {@link #PUBLIC_KEY_RECORD_SIZE}
+     * @return 写入完成时为 out
+     */
+    public CompletableFuture<ByteBuffer> getPublicKeysAsync(CoinType coin, int account, int change, int start, int count, ByteBuffer out) {
+        int offset = checkRecords(out, count, PUBLIC_KEY_RECORD_SIZE);
+        CompletableFuture<Void> done = new CompletableFuture<>();
+        try {
+            getPublicKeysAsync0(handle(), coin.getId(), account, change, start, count, out, offset, done);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
+        return done.thenApply(ignored -> out);
+    }
+
+    /**
+     * 检查批量接口的输出缓冲区，返回写入的起始位置
+     */
+    private static int checkRecords(ByteBuffer out, int count, int recordSize) {
+        if (!out.isDirect()) {
+            throw new IllegalArgumentException("Buffer must be a direct ByteBuffer");
+        }
+        if (out.isReadOnly()) {
+            throw new ReadOnlyBufferException();
+        }
+        if (count < 0 || (long) count * recordSize > out.remaining()) {
+            throw new BufferOverflowException();
+        }
+        return out.position();
     }
 
     /**
@@ -80,7 +328,11 @@ public final class HDWallet {
      * @return 扩展私钥
      */
     public String getPrivateExtended(CoinType coin, int account) {
-        return getPrivateExtendedFromSeed(seed, coin.getId(), account);
+        try {
+            return getPrivateExtended0(handle(), coin.getId(), account);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
     }
 
     /**
@@ -91,7 +343,11 @@ public final class HDWallet {
      * @return 扩展公钥
      */
     public String getPublicExtended(CoinType coin, int account) {
-        return getPublicExtendedFromSeed(seed, coin.getId(), account);
+        try {
+            return getPublicExtended0(handle(), coin.getId(), account);
+        } finally {
+            Reference.reachabilityFence(this);
+        }
     }
 
     /**
@@ -138,13 +394,73 @@ public final class HDWallet {
         return getTronAddressFromPubExtended0(extended, path);
     }
 
-    private static native byte[] getPrivateKeyFromSeedWithPath(byte[] seed, String path);
-    private static native byte[] getPublicKeyFromSeedWithPath(byte[] seed, String path);
-    private static native String getTronAddressFromSeed(byte[] seed, String path);
-    private static native String getPrivateExtendedFromSeed(byte[] seed, int coin, int account);
-    private static native String getPublicExtendedFromSeed(byte[] seed, int coin, int account);
+    /**
+     * 从账户级扩展密钥批量派生TRON地址，写入方式同 {@link #getTronAddresses}
+     *
+     * @param extended 扩展公钥或扩展私钥
+     * @param change   0 为收款地址，1 为找零地址
+     * @param start    起始地址序号
+     * @param count    地址数量
+     * @param out      直接缓冲区，剩余空间至少为 count * {@link #TRON_ADDRESS_RECORD_SIZE}
+     */
+    public static void getTronAddressesFromExtended(String extended, int change, int start, int count, ByteBuffer out) {
+        int offset = checkRecords(out, count, TRON_ADDRESS_RECORD_SIZE);
+        getTronAddressesFromExtended0(extended, change, start, count, out, offset);
+        out.position(offset + count * TRON_ADDRESS_RECORD_SIZE);
+    }
+
+    /**
+     * 从账户级扩展密钥批量派生压缩公钥，写入方式同 {@link #getTronAddresses}
+     *
+     * @param extended 扩展公钥或扩展私钥
+     * @param change   0 为收款地址，1 为找零地址
+     * @param start    起始地址序号
+     * @param count    公钥数量
+     * @param out      直接缓冲区，剩余空间至少为 count * {@link #PUBLIC_KEY_RECORD_SIZE}
+     */
+    public static void getPublicKeysFromExtended(String extended, int change, int start, int count, ByteBuffer out) {
+        int offset = checkRecords(out, count, PUBLIC_KEY_RECORD_SIZE);
+        getPublicKeysFromExtended0(extended, change, start, count, out, offset);
+        out.position(offset + count * PUBLIC_KEY_RECORD_SIZE);
+    }
+
+    /**
+     * {@link #getTronAddressesFromExtended} 的异步版本，写入方式同 {@link #getTronAddressesAsync}
+     *
+     * @param extended 扩展公钥或扩展私钥
+     * @param change   0 为收款地址，1 为找零地址
+     * @param start    起始地址序号
+     * @param count    地址数量
+     * @param out      直接缓冲区，剩余空间至少为 count * {@link #TRON_ADDRESS_RECORD_SIZE}
+     * @return 写入完成时为 out
+     */
+    public static CompletableFuture<ByteBuffer> getTronAddressesFromExtendedAsync(String extended, int change, int start, int count, ByteBuffer out) {
+        int offset = checkRecords(out, count, TRON_ADDRESS_RECORD_SIZE);
+        CompletableFuture<Void> done = new CompletableFuture<>();
+        getTronAddressesFromExtendedAsync0(extended, change, start, count, out, offset, done);
+        return done.thenApply(ignored -> out);
+    }
+
+    private static native long create(byte[] seed);
+    private static native void destroy(long handle);
+    private static native byte[] getPrivateKey0(long handle, String path);
+    private static native byte[] getPublicKey0(long handle, String path);
+    private static native String getTronAddress0(long handle, String path);
+    private static native byte[] getPrivateKeyAt(long handle, int coin, int account, int change, int index);
+    private static native byte[] getPublicKeyAt(long handle, int coin, int account, int change, int index);
+    private static native String getTronAddressAt(long handle, int account, int change, int index);
+    private static native String getPrivateExtended0(long handle, int coin, int account);
+    private static native String getPublicExtended0(long handle, int coin, int account);
     private static native byte[] getPublicKeyFromExtended0(String extended, String path);
     private static native byte[] getPrivateKeyFromExtended0(String extended, String path);
     private static native String getTronAddressFromPrvExtended0(String extended, String path);
     private static native String getTronAddressFromPubExtended0(String extended, String path);
+    private static native void getTronAddresses0(long handle, int account, int change, int start, int count, ByteBuffer out, int offset);
+    private static native void getPublicKeys0(long handle, int coin, int account, int change, int start, int count, ByteBuffer out, int offset);
+    private static native void getTronAddressesFromExtended0(String extended, int change, int start, int count, ByteBuffer out, int offset);
+    private static native void getPublicKeysFromExtended0(String extended, int change, int start, int count, ByteBuffer out, int offset);
+    private static native void getTronAddressAsync0(long handle, int account, int change, int index, CompletableFuture<String> future);
+    private static native void getTronAddressesAsync0(long handle, int account, int change, int start, int count, ByteBuffer out, int offset, CompletableFuture<Void> future);
+    private static native void getPublicKeysAsync0(long handle, int coin, int account, int change, int start, int count, ByteBuffer out, int offset, CompletableFuture<Void> future);
+    private static native void getTronAddressesFromExtendedAsync0(String extended, int change, int start, int count, ByteBuffer out, int offset, CompletableFuture<Void> future);
 }
@@ -0,0 +1,127 @@
+#include "jni_async.h"
+
+#include <stdexcept>
+
+#include "thread_pool.h"
+#include "wallet_core/init.h"
+
+namespace {
+JavaVM* g_vm = nullptr;
+jmethodID g_complete = nullptr;
+jmethodID g_complete_exceptionally = nullptr;
+jclass g_illegal_argument = nullptr;
+jmethodID g_illegal_argument_init = nullptr;
+jclass g_runtime_exception = nullptr;
+jmethodID g_runtime_exception_init = nullptr;
+
+// 每个任务最多用到的局部引用数量
+constexpr jint TASK_LOCAL_REFS = 16;
+
+wallet::ThreadPool& nativePool() {
+    // 工作线程以守护线程身份附加到 JVM，与进程同生命周期，不主动销毁
+    static auto* pool = new wallet::ThreadPool();
+    return *pool;
+}
+
+// 当前工作线程的 JNIEnv，首次使用时附加到 JVM
+JNIEnv* attachedEnv() {
+    thread_local JNIEnv* env = nullptr;
+    if (!env && g_vm) {
+        JavaVMAttachArgs args{JNI_VERSION_1_8, const_cast<char*>("walletcore-worker"), nullptr};
+        if (g_vm->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&env), &args) != JNI_OK) {
+            env = nullptr;
+        }
+    }
+    return env;
+}
+
+jclass globalClass(JNIEnv* env, const char* name) {
+    jclass local = env->FindClass(name);
+    if (!local) {
+        return nullptr;
+    }
+    auto global = static_cast<jclass>(env->NewGlobalRef(local));
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+jobject newException(JNIEnv* env, const std::exception& e) {
+    const bool invalid = dynamic_cast<const std::invalid_argument*>(&e) != nullptr;
+    jclass clazz = invalid ? g_illegal_argument : g_runtime_exception;
+    jmethodID init = invalid ? g_illegal_argument_init : g_runtime_exception_init;
+    return env->NewObject(clazz, init, env->NewStringUTF(e.what()));
+}
+
+void runTask(jobject future, jobject keep_alive, const std::function<jobject(JNIEnv*)>& work) {
+    JNIEnv* env = attachedEnv();
+    if (!env) {
+        // 无法附加到 JVM 时也无法完成 future，只能放弃
+        return;
+    }
+    // 工作线程不会返回 Java，局部引用需要自己释放
+    env->PushLocalFrame(TASK_LOCAL_REFS);
+    jobject result = nullptr;
+    jobject error = nullptr;
+    try {
+        result = work(env);
+    } catch (const std::exception& e) {
+        if (!env->ExceptionCheck()) {
+            error = newException(env, e);
+        }
+    }
+    if (env->ExceptionCheck()) {
+        error = env->ExceptionOccurred();
+        env->ExceptionClear();
+    }
+    if (error) {
+        env->CallBooleanMethod(future, g_complete_exceptionally, error);
+    } else {
+        env->CallBooleanMethod(future, g_complete, result);
+    }
+    // 回调中抛出的异常由 CompletableFuture 自己处理，这里只需清除
+    env->ExceptionClear();
+    env->PopLocalFrame(nullptr);
+    env->DeleteGlobalRef(future);
+    if (keep_alive) {
+        env->DeleteGlobalRef(keep_alive);
+    }
+}
+}  // namespace
+
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8) != JNI_OK) {
+        return JNI_ERR;
+    }
+    // 加载时就创建 secp256k1 上下文，而不是在第一次请求时
+    try {
+        wallet::init();
+    } catch (const std::exception&) {
+        return JNI_ERR;
+    }
+    g_vm = vm;
+    jclass future = env->FindClass("java/util/concurrent/CompletableFuture");
+    g_illegal_argument = globalClass(env, "java/lang/IllegalArgumentException");
+    g_runtime_exception = globalClass(env, "java/lang/RuntimeException");
+    if (!future || !g_illegal_argument || !g_runtime_exception) {
+        return JNI_ERR;
+    }
+    g_complete = env->GetMethodID(future, "complete", "(Ljava/lang/Object;)Z");
+    g_complete_exceptionally = env->GetMethodID(future, "completeExceptionally", "(Ljava/lang/Throwable;)Z");
+    g_illegal_argument_init = env->GetMethodID(g_illegal_argument, "<init>", "(Ljava/lang/String;)V");
+    g_runtime_exception_init = env->GetMethodID(g_runtime_exception, "<init>", "(Ljava/lang/String;)V");
+    env->DeleteLocalRef(future);
+    if (!g_complete || !g_complete_exceptionally || !g_illegal_argument_init || !g_runtime_exception_init) {
+        return JNI_ERR;
+    }
+    return JNI_VERSION_1_8;
+}
+
+void submitAsync(JNIEnv* env, jobject future, jobject keep_alive,
+                 std::function<jobject(JNIEnv*)> work) {
+    jobject future_ref = env->NewGlobalRef(future);
+    jobject keep_alive_ref = keep_alive ? env->NewGlobalRef(keep_alive) : nullptr;
+    nativePool().submit([future_ref, keep_alive_ref, work = std::move(work)] {
+        runTask(future_ref, keep_alive_ref, work);
+    });
+}
@@ -0,0 +1,24 @@
+#ifndef JNI_ASYNC_H
+#define JNI_ASYNC_H
+
+#include <jni.h>
+
+#include <functional>
+
+#include "jni_base.h"
+
+EXTERN_C_BEGIN
+
+// 缓存 JavaVM 以及 CompletableFuture 等类的全局引用
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved);
+
+EXTERN_C_END
+
+// 在原生线程池中执行 work，并用它返回的对象完成 future。
+// work 在已附加到 JVM 的工作线程上运行，返回的局部引用可以为 nullptr；
+// 抛出的 C++ 异常或留下的 Java 异常会让 future 异常完成。
+// keep_alive 在任务结束前持有全局引用，例如 work 写入的直接缓冲区。
+void submitAsync(JNIEnv* env, jobject future, jobject keep_alive,
+                 std::function<jobject(JNIEnv*)> work);
+
+#endif // JNI_ASYNC_H
@@ -1,12 +1,22 @@
 #include "jni_hd_wallet.h"
+#include "jni_async.h"
 
 #include "wallet_core/hd_wallet.h"
 #include "wallet_core/derivation_path.h"
+#include "wallet_core/extended_key.h"
 #include <array>
 #include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <span>
+#include <stdexcept>
 #include "wallet_core/tron.h"
+#include "support/cleanse.h"
+
+static constexpr jint TRON_COIN = 195;
+// 批量接口每次派生的数量，中间结果放在栈上
+static constexpr size_t RECORD_CHUNK = 256;
 
 
 static jstring toJavaString(JNIEnv* env, const std::string &str){
@@ -21,14 +31,6 @@ static std::string jstringToStdString(JNIEnv* env, jstring jStr) {
     return result;
 }
 
-static std::vector<byte> javaByteArrayToStdVec(JNIEnv* env, jbyteArray data) {
-    jsize data_len = env->GetArrayLength(data);
-    std::vector<byte> vec(data_len);
-    env->GetByteArrayRegion(data, 0, data_len, reinterpret_cast<jbyte*>(vec.data()));
-    return vec;
-}
-
-
 static jbyteArray toJavaBytes(JNIEnv *env, const std::span<byte>& span) {
     auto span_size = span.size();
     jbyteArray result = env->NewByteArray(static_cast<jsize>(span_size));
@@ -42,54 +44,251 @@ static jbyteArray toJavaBytes(JNIEnv *env, const std::span<byte>& span) {
 }
 
 
-JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPrivateKeyFromSeedWithPath(JNIEnv *env, jclass clazz, jbyteArray seed, jstring path) {
-    auto seed_data = javaByteArrayToStdVec(env, seed);
-    // 通过随机种子构造分层钱包实例
-    wallet::HDWallet hd_wallet{seed_data};
-    auto path_str = jstringToStdString(env, path);
-    // 构造派生路径类型
-    auto d_path = wallet::DerivationPath{ path_str };
-    // 获取私钥
-    auto private_key = hd_wallet.getKey(d_path);
-    auto private_key_data = private_key.data();
-    return toJavaBytes(env, private_key_data);
+static void throwJavaException(JNIEnv* env, const char* class_name, const char* message) {
+    jclass clazz = env->FindClass(class_name);
+    if (clazz) {
+        env->ThrowNew(clazz, message);
+    }
 }
 
-JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPublicKeyFromSeedWithPath(JNIEnv *env, jclass clazz, jbyteArray seed, jstring path) {
-    auto seed_data = javaByteArrayToStdVec(env, seed);
-    wallet::HDWallet hd_wallet{seed_data};
-    auto path_str = jstringToStdString(env, path);
-    auto d_path = wallet::DerivationPath{ path_str };
-    auto private_key = hd_wallet.getKey(d_path);
-    auto public_key = private_key.getPublicKey();
-    auto public_key_data = public_key.data();
-    return toJavaBytes(env, public_key_data);
+// 把 C++ 异常转换成 Java 异常，异常不能穿过 JNI 边界
+template <typename F>
+static auto rethrowToJava(JNIEnv* env, F&& f) -> decltype(f()) {
+    try {
+        return f();
+    } catch (const std::invalid_argument& e) {
+        throwJavaException(env, "java/lang/IllegalArgumentException", e.what());
+    } catch (const std::exception& e) {
+        throwJavaException(env, "java/lang/RuntimeException", e.what());
+    }
+    return decltype(f())();
 }
 
+// 句柄指向持有钱包的 shared_ptr，异步任务各自持有一份，close 之后仍可安全完成
+using WalletHolder = std::shared_ptr<const wallet::HDWallet>;
 
-JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getTronAddressFromSeed(JNIEnv *env, jclass clazz, jbyteArray seed, jstring path) {
-    auto seed_data = javaByteArrayToStdVec(env, seed);
-    wallet::HDWallet hd_wallet{seed_data};
-    auto path_str = jstringToStdString(env, path);
-    auto d_path = wallet::DerivationPath{ path_str };
-    auto private_key = hd_wallet.getKey(d_path);
-    auto public_key = private_key.getPublicKey();
-    auto addr = wallet::tron::TronAddress::derive_from_public_key(public_key);
-    return toJavaString(env, addr.string());
+static const WalletHolder& holderFromHandle(jlong handle) {
+    return *reinterpret_cast<const WalletHolder*>(static_cast<intptr_t>(handle));
+}
+
+static const wallet::HDWallet& fromHandle(jlong handle) {
+    return *holderFromHandle(handle);
+}
+
+static wallet::DerivationPath bip44Path(jint coin, jint account, jint change, jint index) {
+    if ((coin | account | change | index) < 0) {
+        throw std::invalid_argument("Path components must not be negative");
+    }
+    return wallet::DerivationPath(wallet::Purpose::BIP44, coin, account, change, index);
+}
+
+JNIEXPORT jlong Java_com_github_militch_walletj_HDWallet_create(JNIEnv *env, jclass clazz, jbyteArray seed) {
+    wallet::HDWallet::SeedData seed_data;
+    if (env->GetArrayLength(seed) != static_cast<jsize>(seed_data.size())) {
+        throwJavaException(env, "java/lang/IllegalArgumentException", "Seed must be 64 bytes");
+        return 0;
+    }
+    env->GetByteArrayRegion(seed, 0, static_cast<jsize>(seed_data.size()),
+                            reinterpret_cast<jbyte*>(seed_data.data()));
+    // 通过随机种子构造分层钱包实例，由 Java 端持有并在 close 时释放
+    auto* holder = new WalletHolder(std::make_shared<const wallet::HDWallet>(seed_data));
+    memory_cleanse(seed_data.data(), seed_data.size());
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(holder));
+}
+
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_destroy(JNIEnv *env, jclass clazz, jlong handle) {
+    // 最后一个引用释放时钱包析构，擦除种子和缓存的节点
+    delete reinterpret_cast<WalletHolder*>(static_cast<intptr_t>(handle));
+}
+
+JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPrivateKey0(JNIEnv *env, jclass clazz, jlong handle, jstring path) {
+    return rethrowToJava(env, [&] {
+        auto d_path = wallet::DerivationPath{ jstringToStdString(env, path) };
+        auto private_key = fromHandle(handle).getKey(d_path);
+        auto private_key_data = private_key.data();
+        return toJavaBytes(env, private_key_data);
+    });
+}
+
+JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPublicKey0(JNIEnv *env, jclass clazz, jlong handle, jstring path) {
+    return rethrowToJava(env, [&] {
+        auto d_path = wallet::DerivationPath{ jstringToStdString(env, path) };
+        auto public_key = fromHandle(handle).getKey(d_path).getPublicKey();
+        auto public_key_data = public_key.data();
+        return toJavaBytes(env, public_key_data);
+    });
+}
+
+JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getTronAddress0(JNIEnv *env, jclass clazz, jlong handle, jstring path) {
+    return rethrowToJava(env, [&] {
+        auto d_path = wallet::DerivationPath{ jstringToStdString(env, path) };
+        auto addr = fromHandle(handle).getTronAddress(d_path);
+        return toJavaString(env, addr.string());
+    });
+}
+
+JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPrivateKeyAt(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account, jint change, jint index) {
+    return rethrowToJava(env, [&] {
+        auto private_key = fromHandle(handle).getKey(bip44Path(coin, account, change, index));
+        auto private_key_data = private_key.data();
+        return toJavaBytes(env, private_key_data);
+    });
+}
+
+JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPublicKeyAt(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account, jint change, jint index) {
+    return rethrowToJava(env, [&] {
+        auto public_key = fromHandle(handle).getKey(bip44Path(coin, account, change, index)).getPublicKey();
+        auto public_key_data = public_key.data();
+        return toJavaBytes(env, public_key_data);
+    });
+}
+
+JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getTronAddressAt(JNIEnv *env, jclass clazz, jlong handle, jint account, jint change, jint index) {
+    return rethrowToJava(env, [&] {
+        auto addr = fromHandle(handle).getTronAddress(bip44Path(TRON_COIN, account, change, index));
+        return toJavaString(env, addr.string());
+    });
+}
+
+JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getPrivateExtended0(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account) {
+    return rethrowToJava(env, [&] {
+        return toJavaString(env, fromHandle(handle).getExtendedPrivateKeyAccount(coin, account));
+    });
+}
+
+JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getPublicExtended0(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account) {
+    return rethrowToJava(env, [&] {
+        return toJavaString(env, fromHandle(handle).getExtendedPublicKeyAccount(coin, account));
+    });
+}
+
+// 直接缓冲区中从 offset 开始存放 count 条记录的区域
+static byte* directBufferRecords(JNIEnv* env, jobject buffer, jint offset, jint count, size_t record_size) {
+    auto* base = static_cast<byte*>(env->GetDirectBufferAddress(buffer));
+    const jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (!base || capacity < 0) {
+        throw std::invalid_argument("Buffer must be a direct ByteBuffer");
+    }
+    if (offset < 0 || count < 0 ||
+        static_cast<uint64_t>(offset) + static_cast<uint64_t>(count) * record_size > static_cast<uint64_t>(capacity)) {
+        throw std::invalid_argument("Buffer is too small");
+    }
+    return base + offset;
+}
+
+static void checkRange(jint change, jint start) {
+    if (change < 0 || start < 0) {
+        throw std::invalid_argument("Path components must not be negative");
+    }
+}
+
+static wallet::ExtendedKey accountKey(const wallet::HDWallet& hd_wallet, jint coin, jint account) {
+    if (coin < 0 || account < 0) {
+        throw std::invalid_argument("Path components must not be negative");
+    }
+    return wallet::ExtendedKey::parse(hd_wallet.getExtendedPublicKeyAccount(coin, account));
+}
+
+// 每条记录是 34 字节的 Base58 地址字符串
+static void writeTronAddresses(const wallet::ExtendedKey& key, jint change, jint start, jint count, byte* out) {
+    using wallet::tron::TronAddress;
+    static_assert(sizeof(std::array<char, TronAddress::STRING_SIZE>) == TronAddress::STRING_SIZE);
+    std::array<TronAddress::Data, RECORD_CHUNK> data;
+    std::array<std::array<char, TronAddress::STRING_SIZE>, RECORD_CHUNK> strings;
+    for (size_t done = 0; done < static_cast<size_t>(count); done += RECORD_CHUNK) {
+        const size_t n = std::min(RECORD_CHUNK, static_cast<size_t>(count) - done);
+        key.deriveTronAddressRange(change, start + static_cast<uint32_t>(done), std::span(data).first(n));
+        TronAddress::to_strings(std::span(data).first(n), std::span(strings).first(n));
+        std::memcpy(out + done * TronAddress::STRING_SIZE, strings.data(), n * TronAddress::STRING_SIZE);
+    }
+}
+
+// 每条记录是 33 字节的压缩公钥
+static void writePublicKeys(const wallet::ExtendedKey& key, jint change, jint start, jint count, byte* out) {
+    using KeyData = wallet::PublicKey::KeyData;
+    static_assert(sizeof(KeyData) == 33);
+    std::array<KeyData, RECORD_CHUNK> keys;
+    for (size_t done = 0; done < static_cast<size_t>(count); done += RECORD_CHUNK) {
+        const size_t n = std::min(RECORD_CHUNK, static_cast<size_t>(count) - done);
+        key.deriveRange(change, start + static_cast<uint32_t>(done), std::span(keys).first(n));
+        std::memcpy(out + done * sizeof(KeyData), keys.data(), n * sizeof(KeyData));
+    }
+}
+
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddresses0(JNIEnv *env, jclass clazz, jlong handle, jint account, jint change, jint start, jint count, jobject out, jint offset) {
+    rethrowToJava(env, [&] {
+        auto* records = directBufferRecords(env, out, offset, count, wallet::tron::TronAddress::STRING_SIZE);
+        checkRange(change, start);
+        writeTronAddresses(accountKey(fromHandle(handle), TRON_COIN, account), change, start, count, records);
+    });
+}
+
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getPublicKeys0(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account, jint change, jint start, jint count, jobject out, jint offset) {
+    rethrowToJava(env, [&] {
+        auto* records = directBufferRecords(env, out, offset, count, sizeof(wallet::PublicKey::KeyData));
+        checkRange(change, start);
+        writePublicKeys(accountKey(fromHandle(handle), coin, account), change, start, count, records);
+    });
 }
 
-JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getPrivateExtendedFromSeed(JNIEnv *env, jclass clazz, jbyteArray seed, jint coin, jint account) {
-    auto seed_data = javaByteArrayToStdVec(env, seed);
-    wallet::HDWallet hd_wallet{seed_data};
-    std::string extended = hd_wallet.getExtendedPrivateKeyAccount(coin, account);
-    return toJavaString(env, extended);
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddressesFromExtended0(JNIEnv *env, jclass clazz, jstring extended, jint change, jint start, jint count, jobject out, jint offset) {
+    rethrowToJava(env, [&] {
+        auto* records = directBufferRecords(env, out, offset, count, wallet::tron::TronAddress::STRING_SIZE);
+        checkRange(change, start);
+        writeTronAddresses(wallet::ExtendedKey::parse(jstringToStdString(env, extended)), change, start, count, records);
+    });
 }
 
-JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getPublicExtendedFromSeed(JNIEnv *env, jclass clazz, jbyteArray seed, jint coin, jint account) {
-    auto seed_data = javaByteArrayToStdVec(env, seed);
-    wallet::HDWallet hd_wallet{seed_data};
-    std::string extended = hd_wallet.getExtendedPublicKeyAccount(coin, account);
-    return toJavaString(env, extended);
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getPublicKeysFromExtended0(JNIEnv *env, jclass clazz, jstring extended, jint change, jint start, jint count, jobject out, jint offset) {
+    rethrowToJava(env, [&] {
+        auto* records = directBufferRecords(env, out, offset, count, sizeof(wallet::PublicKey::KeyData));
+        checkRange(change, start);
+        writePublicKeys(wallet::ExtendedKey::parse(jstringToStdString(env, extended)), change, start, count, records);
+    });
+}
+
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddressAsync0(JNIEnv *env, jclass clazz, jlong handle, jint account, jint change, jint index, jobject future) {
+    rethrowToJava(env, [&] {
+        auto path = bip44Path(TRON_COIN, account, change, index);
+        submitAsync(env, future, nullptr, [hd_wallet = holderFromHandle(handle), path](JNIEnv* env) -> jobject {
+            return toJavaString(env, hd_wallet->getTronAddress(path).string());
+        });
+    });
+}
+
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddressesAsync0(JNIEnv *env, jclass clazz, jlong handle, jint account, jint change, jint start, jint count, jobject out, jint offset, jobject future) {
+    rethrowToJava(env, [&] {
+        auto* records = directBufferRecords(env, out, offset, count, wallet::tron::TronAddress::STRING_SIZE);
+        checkRange(change, start);
+        submitAsync(env, future, out, [hd_wallet = holderFromHandle(handle), account, change, start, count, records](JNIEnv*) -> jobject {
+            writeTronAddresses(accountKey(*hd_wallet, TRON_COIN, account), change, start, count, records);
+            return nullptr;
+        });
+    });
+}
+
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getPublicKeysAsync0(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account, jint change, jint start, jint count, jobject out, jint offset, jobject future) {
+    rethrowToJava(env, [&] {
+        auto* records = directBufferRecords(env, out, offset, count, sizeof(wallet::PublicKey::KeyData));
+        checkRange(change, start);
+        submitAsync(env, future, out, [hd_wallet = holderFromHandle(handle), coin, account, change, start, count, records](JNIEnv*) -> jobject {
+            writePublicKeys(accountKey(*hd_wallet, coin, account), change, start, count, records);
+            return nullptr;
+        });
+    });
+}
+
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddressesFromExtendedAsync0(JNIEnv *env, jclass clazz, jstring extended, jint change, jint start, jint count, jobject out, jint offset, jobject future) {
+    rethrowToJava(env, [&] {
+        auto* records = directBufferRecords(env, out, offset, count, wallet::tron::TronAddress::STRING_SIZE);
+        checkRange(change, start);
+        // 在调用线程上解码，格式错误直接抛出
+        auto key = wallet::ExtendedKey::parse(jstringToStdString(env, extended));
+        submitAsync(env, future, out, [key, change, start, count, records](JNIEnv*) -> jobject {
+            writeTronAddresses(key, change, start, count, records);
+            return nullptr;
+        });
+    });
 }
 
 JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPublicKeyFromExtended0(JNIEnv *env, jclass clazz, jstring extended, jstring path) {
@@ -115,7 +314,7 @@ JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getTronAddressFromPrv
     auto path_str = jstringToStdString(env, path);
     auto d_path = wallet::DerivationPath{ path_str };
     auto private_key = wallet::HDWallet::getPrivateKeyFromExtended(extended_str, d_path);
-    auto addr = wallet::tron::TronAddress::derive_from_public_key(private_key.getPublicKey());
+    auto addr = wallet::tron::TronAddress::derive_from_private_key(private_key);
     return toJavaString(env, addr.string());
 }
 
@@ -123,7 +322,6 @@ JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getTronAddressFromPub
     auto extended_str = jstringToStdString(env, extended);
     auto path_str = jstringToStdString(env, path);
     auto d_path = wallet::DerivationPath{ path_str };
-    auto public_key = wallet::HDWallet::getPublicKeyFromExtended(extended_str, d_path);
-    auto addr = wallet::tron::TronAddress::derive_from_public_key(public_key);
+    auto addr = wallet::HDWallet::getTronAddressFromExtended(extended_str, d_path);
     return toJavaString(env, addr.string());
 }
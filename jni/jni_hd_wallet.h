@@ -7,16 +7,42 @@
 
 EXTERN_C_BEGIN
 
-// 获取从随机种子派生的私钥
-JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPrivateKeyFromSeedWithPath(JNIEnv *env, jclass clazz, jbyteArray seed, jstring path);
-// 获取从随机种子派生的公钥
-JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPublicKeyFromSeedWithPath(JNIEnv *env, jclass clazz, jbyteArray seed, jstring path);
-// 返回从随机种子派生的TRON地址
-JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getTronAddressFromSeed(JNIEnv *env, jclass clazz, jbyteArray seed, jstring path);
-// 获取从随机种子派生的扩展公钥
-JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getPrivateExtendedFromSeed(JNIEnv *env, jclass clazz, jbyteArray seed, jint coin, jint account);
-// 获取从随机种子派生的扩展私钥
-JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getPublicExtendedFromSeed(JNIEnv *env, jclass clazz, jbyteArray seed, jint coin, jint account);
+// 用随机种子创建原生钱包实例，返回其句柄
+JNIEXPORT jlong Java_com_github_militch_walletj_HDWallet_create(JNIEnv *env, jclass clazz, jbyteArray seed);
+// 擦除并释放原生钱包实例
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_destroy(JNIEnv *env, jclass clazz, jlong handle);
+// 获取指定派生路径的私钥
+JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPrivateKey0(JNIEnv *env, jclass clazz, jlong handle, jstring path);
+// 获取指定派生路径的公钥
+JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPublicKey0(JNIEnv *env, jclass clazz, jlong handle, jstring path);
+// 返回指定派生路径的TRON地址
+JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getTronAddress0(JNIEnv *env, jclass clazz, jlong handle, jstring path);
+// 获取 BIP44 路径 m/44'/coin'/account'/change/index 的私钥
+JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPrivateKeyAt(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account, jint change, jint index);
+// 获取 BIP44 路径 m/44'/coin'/account'/change/index 的公钥
+JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPublicKeyAt(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account, jint change, jint index);
+// 返回 BIP44 路径 m/44'/195'/account'/change/index 的TRON地址
+JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getTronAddressAt(JNIEnv *env, jclass clazz, jlong handle, jint account, jint change, jint index);
+// 获取扩展私钥
+JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getPrivateExtended0(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account);
+// 获取扩展公钥
+JNIEXPORT jstring Java_com_github_militch_walletj_HDWallet_getPublicExtended0(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account);
+// 把 account 下 change 链从 start 开始的 count 个TRON地址写入直接缓冲区，每个 34 字节
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddresses0(JNIEnv *env, jclass clazz, jlong handle, jint account, jint change, jint start, jint count, jobject out, jint offset);
+// 把 coin/account 下 change 链从 start 开始的 count 个压缩公钥写入直接缓冲区，每个 33 字节
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getPublicKeys0(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account, jint change, jint start, jint count, jobject out, jint offset);
+// 从账户级扩展密钥批量派生TRON地址写入直接缓冲区
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddressesFromExtended0(JNIEnv *env, jclass clazz, jstring extended, jint change, jint start, jint count, jobject out, jint offset);
+// 从账户级扩展密钥批量派生压缩公钥写入直接缓冲区
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getPublicKeysFromExtended0(JNIEnv *env, jclass clazz, jstring extended, jint change, jint start, jint count, jobject out, jint offset);
+// 在原生线程池中派生TRON地址，完成后以地址字符串完成 future
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddressAsync0(JNIEnv *env, jclass clazz, jlong handle, jint account, jint change, jint index, jobject future);
+// getTronAddresses0 的异步版本，写入完成后完成 future
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddressesAsync0(JNIEnv *env, jclass clazz, jlong handle, jint account, jint change, jint start, jint count, jobject out, jint offset, jobject future);
+// getPublicKeys0 的异步版本，写入完成后完成 future
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getPublicKeysAsync0(JNIEnv *env, jclass clazz, jlong handle, jint coin, jint account, jint change, jint start, jint count, jobject out, jint offset, jobject future);
+// getTronAddressesFromExtended0 的异步版本，写入完成后完成 future
+JNIEXPORT void Java_com_github_militch_walletj_HDWallet_getTronAddressesFromExtendedAsync0(JNIEnv *env, jclass clazz, jstring extended, jint change, jint start, jint count, jobject out, jint offset, jobject future);
 // 返回公钥从序列化的扩展公钥中派生
 JNIEXPORT jbyteArray Java_com_github_militch_walletj_HDWallet_getPublicKeyFromExtended0(JNIEnv *env, jclass clazz, jstring extended, jstring path);
 // 返回私钥从序列化的扩展私钥中派生
@@ -0,0 +1,226 @@
+#include "wallet_core/address_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "crypto/common.h"
+#include "wallet_core/extended_key.h"
+
+using namespace wallet::tron;
+
+namespace {
+// 文件格式（小端）：
+//   magic[8] | count:u64 | buckets:u64[BUCKETS + 1]
+//   | addresses:byte[21][count] | paths:(account, change, index):u32[3][count]
+// buckets[b] 是第一个前缀 >= b 的地址的序号。地址的首字节固定为 0x41，
+// 前缀取其后的两个字节。
+const char MAGIC[8] = {'W', 'C', 'T', 'R', 'X', 'I', 'D', '1'};
+constexpr size_t BUCKETS = 1 << 16;
+constexpr size_t ADDRESS_SIZE = std::tuple_size_v<TronAddress::Data>;
+constexpr size_t PATH_SIZE = 12;
+constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 8 + 8 * (BUCKETS + 1);
+
+size_t bucket_of(const byte* address) {
+  return (size_t{address[1]} << 8) | address[2];
+}
+}  // namespace
+
+void AddressIndexBuilder::add_range(const ExtendedKey& key, uint32_t account,
+                                    uint32_t change, uint32_t start,
+                                    uint32_t count) {
+  const size_t offset = entries_.size();
+  std::vector<TronAddress::Data> addresses(count);
+  key.deriveTronAddressRange(change, start, addresses);
+  entries_.resize(offset + count);
+  for (uint32_t i = 0; i < count; ++i) {
+    entries_[offset + i] = Entry{addresses[i], AddressPath{account, change, start + i}};
+  }
+}
+
+void AddressIndexBuilder::add(const TronAddress::Data& address,
+                              const AddressPath& path) {
+  if (address[0] != 0x41) {
+    throw std::invalid_argument("Not a Tron address");
+  }
+  entries_.push_back(Entry{address, path});
+}
+
+void AddressIndexBuilder::write(const std::string& file) {
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const Entry& a, const Entry& b) { return a.address < b.address; });
+  entries_.erase(std::unique(entries_.begin(), entries_.end(),
+                             [](const Entry& a, const Entry& b) { return a.address == b.address; }),
+                 entries_.end());
+
+  std::vector<byte> header(HEADER_SIZE);
+  std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+  WriteLE64(header.data() + sizeof(MAGIC), entries_.size());
+  byte* buckets = header.data() + sizeof(MAGIC) + 8;
+  size_t pos = 0;
+  for (size_t b = 0; b <= BUCKETS; ++b) {
+    while (pos < entries_.size() && bucket_of(entries_[pos].address.data()) < b) {
+      ++pos;
+    }
+    WriteLE64(buckets + 8 * b, pos);
+  }
+
+  std::ofstream out(file, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(header.data()), header.size());
+  for (const auto& entry : entries_) {
+    out.write(reinterpret_cast<const char*>(entry.address.data()), ADDRESS_SIZE);
+  }
+  for (const auto& entry : entries_) {
+    byte path[PATH_SIZE];
+    WriteLE32(path, entry.path.account);
+    WriteLE32(path + 4, entry.path.change);
+    WriteLE32(path + 8, entry.path.index);
+    out.write(reinterpret_cast<const char*>(path), sizeof(path));
+  }
+  out.close();
+  if (!out) {
+    throw std::runtime_error("Failed to write address index " + file);
+  }
+}
+
+AddressIndex::AddressIndex(const std::string& file) {
+#ifdef _WIN32
+  HANDLE handle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Failed to open address index " + file);
+  }
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(handle, &size)) {
+    length_ = static_cast<size_t>(size.QuadPart);
+    mapping_ = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  }
+  CloseHandle(handle);
+  if (mapping_ != nullptr) {
+    base_ = static_cast<const byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  }
+  if (base_ == nullptr) {
+    unmap();
+    throw std::runtime_error("Failed to map address index " + file);
+  }
+#else
+  int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open address index " + file);
+  }
+  struct stat st;
+  void* map = MAP_FAILED;
+  if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+    length_ = static_cast<size_t>(st.st_size);
+    map = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    throw std::runtime_error("Failed to map address index " + file);
+  }
+  // 查找是随机访问，关闭预读
+  ::madvise(map, length_, MADV_RANDOM);
+  base_ = static_cast<const byte*>(map);
+#endif
+
+  if (length_ < HEADER_SIZE || std::memcmp(base_, MAGIC, sizeof(MAGIC)) != 0) {
+    unmap();
+    throw std::runtime_error("Not an address index: " + file);
+  }
+  const uint64_t count = ReadLE64(base_ + sizeof(MAGIC));
+  buckets_ = base_ + sizeof(MAGIC) + 8;
+  if (count > (length_ - HEADER_SIZE) / (ADDRESS_SIZE + PATH_SIZE) ||
+      length_ != HEADER_SIZE + count * (ADDRESS_SIZE + PATH_SIZE) ||
+      ReadLE64(buckets_ + 8 * BUCKETS) != count) {
+    unmap();
+    throw std::runtime_error("Corrupt address index: " + file);
+  }
+  count_ = count;
+  addresses_ = base_ + HEADER_SIZE;
+  paths_ = addresses_ + count_ * ADDRESS_SIZE;
+}
+
+AddressIndex::AddressIndex(AddressIndex&& other) noexcept
+    : base_(std::exchange(other.base_, nullptr)),
+      length_(std::exchange(other.length_, 0)),
+      count_(std::exchange(other.count_, 0)),
+      buckets_(std::exchange(other.buckets_, nullptr)),
+      addresses_(std::exchange(other.addresses_, nullptr)),
+      paths_(std::exchange(other.paths_, nullptr))
+#ifdef _WIN32
+      ,
+      mapping_(std::exchange(other.mapping_, nullptr))
+#endif
+{
+}
+
+AddressIndex& AddressIndex::operator=(AddressIndex&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    base_ = std::exchange(other.base_, nullptr);
+    length_ = std::exchange(other.length_, 0);
+    count_ = std::exchange(other.count_, 0);
+    buckets_ = std::exchange(other.buckets_, nullptr);
+    addresses_ = std::exchange(other.addresses_, nullptr);
+    paths_ = std::exchange(other.paths_, nullptr);
+#ifdef _WIN32
+    mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+  }
+  return *this;
+}
+
+AddressIndex::~AddressIndex() { unmap(); }
+
+void AddressIndex::unmap() {
+#ifdef _WIN32
+  if (base_ != nullptr) {
+    UnmapViewOfFile(base_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+    mapping_ = nullptr;
+  }
+#else
+  if (base_ != nullptr) {
+    ::munmap(const_cast<byte*>(base_), length_);
+  }
+#endif
+  base_ = nullptr;
+  length_ = 0;
+  count_ = 0;
+}
+
+std::optional<AddressPath> AddressIndex::find(const TronAddress::Data& address) const {
+  const size_t bucket = bucket_of(address.data());
+  size_t lo = ReadLE64(buckets_ + 8 * bucket);
+  size_t hi = ReadLE64(buckets_ + 8 * (bucket + 1));
+  if (hi > count_ || lo > hi) {
+    return std::nullopt;
+  }
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    const int cmp = std::memcmp(addresses_ + mid * ADDRESS_SIZE, address.data(), ADDRESS_SIZE);
+    if (cmp == 0) {
+      const byte* path = paths_ + mid * PATH_SIZE;
+      return AddressPath{ReadLE32(path), ReadLE32(path + 4), ReadLE32(path + 8)};
+    }
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return std::nullopt;
+}
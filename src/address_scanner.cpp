@@ -0,0 +1,130 @@
+#include "wallet_core/address_scanner.h"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "thread_pool.h"
+#include "wallet_core/derivation_engine.h"
+#include "wallet_core/extended_key.h"
+
+using namespace wallet;
+
+namespace {
+// 每个工作线程每批派生的地址数量，与 DerivationEngine 的任务粒度一致
+constexpr size_t ADDRESSES_PER_WORKER = 256;
+constexpr uint32_t TRON_COIN = 195;
+
+AddressScanner::UsedOracle set_oracle(const std::set<tron::TronAddress::Data>& used) {
+    return [&used](std::span<const tron::TronAddress::Data> addresses, std::span<bool> out) {
+        for (size_t i = 0; i < addresses.size(); ++i) {
+            out[i] = used.count(addresses[i]) != 0;
+        }
+    };
+}
+}  // namespace
+
+AddressScanner::AddressScanner(DerivationEngine& engine, uint32_t gap_limit, size_t batch)
+    : engine_(engine), gap_limit_(gap_limit), batch_(batch) {
+    if (gap_limit_ == 0) {
+        throw std::invalid_argument("Gap limit must be positive");
+    }
+    if (batch_ == 0) {
+        batch_ = engine_.threads() * ADDRESSES_PER_WORKER;
+    }
+    batch_ = std::max<size_t>(batch_, gap_limit_);
+}
+
+std::vector<uint32_t> AddressScanner::scanChain(const ExtendedKey& key, uint32_t change,
+                                                const UsedOracle& used) const {
+    if (change & 0x80000000) {
+        throw std::invalid_argument("Change index must not be hardened");
+    }
+    // 批次从 gap limit 开始逐次翻倍，地址少的账户不会多派生太多
+    size_t grow = gap_limit_;
+    auto batch_at = [this, &grow](uint64_t start) {
+        const size_t batch = std::min(grow, batch_);
+        grow = std::min(grow * 2, batch_);
+        return static_cast<size_t>(std::min<uint64_t>(batch, 0x80000000 - start));
+    };
+
+    std::vector<tron::TronAddress::Data> current(batch_), next(batch_);
+    std::unique_ptr<bool[]> flags(new bool[batch_]);
+    std::vector<uint32_t> found;
+
+    uint64_t start = 0;
+    size_t count = batch_at(start);
+    engine_.deriveTronAddressRange(key, change, 0, std::span(current).first(count));
+    uint32_t gap = 0;
+    for (;;) {
+        // 在工作线程上检查当前批次，同时预先派生下一批
+        auto checked = std::make_shared<std::promise<void>>();
+        auto done = checked->get_future();
+        std::span<const tron::TronAddress::Data> addresses(current.data(), count);
+        std::span<bool> out(flags.get(), count);
+        engine_.pool_->submit([checked, &used, addresses, out] {
+            try {
+                used(addresses, out);
+                checked->set_value();
+            } catch (...) {
+                checked->set_exception(std::current_exception());
+            }
+        });
+
+        const uint64_t next_start = start + count;
+        const size_t next_count = batch_at(next_start);
+        std::exception_ptr error;
+        try {
+            engine_.deriveTronAddressRange(key, change, static_cast<uint32_t>(next_start),
+                                           std::span(next).first(next_count));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // 无论如何都要等检查结束，它还引用着 current
+        done.get();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (flags[i]) {
+                found.push_back(static_cast<uint32_t>(start + i));
+                gap = 0;
+            } else if (++gap == gap_limit_) {
+                return found;
+            }
+        }
+        if (next_count == 0) {
+            return found;
+        }
+        std::swap(current, next);
+        start = next_start;
+        count = next_count;
+    }
+}
+
+std::vector<uint32_t> AddressScanner::scanChain(
+    const ExtendedKey& key, uint32_t change,
+    const std::set<tron::TronAddress::Data>& used) const {
+    return scanChain(key, change, set_oracle(used));
+}
+
+std::vector<DerivationPath> AddressScanner::scanAccount(const ExtendedKey& key, uint32_t account,
+                                                        const UsedOracle& used) const {
+    std::vector<DerivationPath> paths;
+    for (uint32_t change = 0; change < 2; ++change) {
+        for (uint32_t index : scanChain(key, change, used)) {
+            paths.emplace_back(Purpose::BIP44, TRON_COIN, account, change, index);
+        }
+    }
+    return paths;
+}
+
+std::vector<DerivationPath> AddressScanner::scanAccount(
+    const ExtendedKey& key, uint32_t account,
+    const std::set<tron::TronAddress::Data>& used) const {
+    return scanAccount(key, account, set_oracle(used));
+}
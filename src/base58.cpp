@@ -4,11 +4,13 @@
 
 #include "base58.h"
 
+#include "crypto/common.h"
 #include "hash.h"
 #include "uint256.h"
 #include "util/strencodings.h"
 #include "util/string.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -143,6 +145,223 @@ std::string EncodeBase58Check(std::span<const unsigned char> input)
     return EncodeBase58(vch);
 }
 
+namespace {
+/** 58^5, the base of the limbs used by the fixed-size encoder. A limb times
+ *  2^32 plus a carry still fits in 64 bits, so the conversion needs no
+ *  128-bit arithmetic. */
+constexpr uint64_t BASE58_LIMB = 58ull * 58 * 58 * 58 * 58;
+constexpr size_t BASE58_LIMB_DIGITS = 5;
+
+/** Encode an N-byte input into at most MAX characters at out. The input is
+ *  fed into base 58^5 limbs 32 bits at a time, and each limb yields five
+ *  digits at the end. */
+template <size_t N, size_t MAX>
+size_t EncodeBase58Fixed(const unsigned char* input, char* out)
+{
+    constexpr size_t LIMBS = (MAX + BASE58_LIMB_DIGITS - 1) / BASE58_LIMB_DIGITS;
+    uint64_t limbs[LIMBS] = {}; // Least significant limb first.
+    size_t used = 0;
+    auto push = [&](uint64_t word, int bits) {
+        // Apply "limbs = limbs * 2^bits + word".
+        uint64_t carry = word;
+        size_t i = 0;
+        for (; i < used || carry != 0; ++i) {
+            uint64_t t = (limbs[i] << bits) + carry;
+            limbs[i] = t % BASE58_LIMB;
+            carry = t / BASE58_LIMB;
+        }
+        used = i;
+    };
+    size_t pos = 0;
+    for (; pos < N % 4; ++pos) {
+        push(input[pos], 8);
+    }
+    for (; pos < N; pos += 4) {
+        push(ReadBE32(input + pos), 32);
+    }
+
+    char digits[LIMBS * BASE58_LIMB_DIGITS];
+    for (size_t i = 0; i < LIMBS; ++i) {
+        uint64_t limb = limbs[i];
+        for (size_t j = 0; j < BASE58_LIMB_DIGITS; ++j) {
+            digits[sizeof(digits) - 1 - i * BASE58_LIMB_DIGITS - j] = limb % 58;
+            limb /= 58;
+        }
+    }
+    // Leading zero bytes become '1's; leading zero digits are dropped.
+    size_t zeroes = 0;
+    while (zeroes < N && input[zeroes] == 0) {
+        ++zeroes;
+    }
+    size_t first = 0;
+    while (first < sizeof(digits) && digits[first] == 0) {
+        ++first;
+    }
+    const size_t length = zeroes + sizeof(digits) - first;
+    assert(length <= MAX);
+    std::fill(out, out + zeroes, '1');
+    for (size_t i = first; i < sizeof(digits); ++i) {
+        out[zeroes + i - first] = pszBase58[(uint8_t)digits[i]];
+    }
+    return length;
+}
+
+template <size_t N, size_t MAX>
+size_t EncodeBase58CheckFixed(std::span<const unsigned char, N> input, std::span<char, MAX> out)
+{
+    unsigned char buf[N + 4];
+    std::copy(input.begin(), input.end(), buf);
+    uint256 hash = Hash(input);
+    memcpy(buf + N, hash.data(), 4);
+    return EncodeBase58Fixed<N + 4, MAX>(buf, out.data());
+}
+
+/** Decode str into exactly N bytes at out. Characters are taken five at a
+ *  time and folded into base 2^32 words, the inverse of EncodeBase58Fixed.
+ *  As with DecodeBase58, the leading '1's must match the leading zero bytes
+ *  of the result. */
+template <size_t N>
+bool DecodeBase58Fixed(std::string_view str, unsigned char* out)
+{
+    while (!str.empty() && IsSpace(str.front()))
+        str.remove_prefix(1);
+    while (!str.empty() && IsSpace(str.back()))
+        str.remove_suffix(1);
+    size_t zeroes = 0;
+    while (zeroes < str.size() && str[zeroes] == '1') {
+        if (++zeroes > N) return false;
+    }
+
+    constexpr size_t WORDS = (N + 3) / 4;
+    uint32_t words[WORDS] = {}; // Least significant word first.
+    size_t used = 0;
+    for (size_t pos = 0; pos < str.size(); pos += BASE58_LIMB_DIGITS) {
+        const size_t count = std::min(BASE58_LIMB_DIGITS, str.size() - pos);
+        uint64_t carry = 0;
+        uint64_t scale = 1;
+        for (size_t i = 0; i < count; ++i) {
+            int digit = mapBase58[(uint8_t)str[pos + i]];
+            if (digit == -1) return false;
+            carry = carry * 58 + digit;
+            scale *= 58;
+        }
+        // Apply "words = words * 58^count + carry".
+        size_t i = 0;
+        for (; i < used || carry != 0; ++i) {
+            if (i == WORDS) return false;
+            uint64_t t = words[i] * scale + carry;
+            words[i] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        used = i;
+    }
+    if constexpr (N % 4 != 0) {
+        if (words[WORDS - 1] >> (8 * (N % 4)) != 0) return false;
+    }
+    for (size_t i = 0; i < N; ++i) {
+        out[N - 1 - i] = words[i / 4] >> (8 * (i % 4));
+    }
+    size_t leading = 0;
+    while (leading < N && out[leading] == 0) {
+        ++leading;
+    }
+    return leading == zeroes;
+}
+
+template <size_t N>
+bool DecodeBase58CheckFixed(std::string_view str, std::span<unsigned char, N> out)
+{
+    unsigned char buf[N + 4];
+    if (!DecodeBase58Fixed<N + 4>(str, buf)) return false;
+    uint256 hash = Hash(std::span<const unsigned char, N>(buf, N));
+    if (memcmp(hash.data(), buf + N, 4) != 0) return false;
+    std::copy(buf, buf + N, out.begin());
+    return true;
+}
+} // namespace
+
+size_t EncodeBase58Check(std::span<const unsigned char, 21> input, std::span<char, BASE58CHECK_21_MAX_SIZE> out)
+{
+    return EncodeBase58CheckFixed(input, out);
+}
+
+size_t EncodeBase58Check(std::span<const unsigned char, 78> input, std::span<char, BASE58CHECK_78_MAX_SIZE> out)
+{
+    return EncodeBase58CheckFixed(input, out);
+}
+
+bool DecodeBase58Check(std::string_view str, std::span<unsigned char, 21> out)
+{
+    return DecodeBase58CheckFixed(str, out);
+}
+
+bool DecodeBase58Check(std::string_view str, std::span<unsigned char, 78> out)
+{
+    return DecodeBase58CheckFixed(str, out);
+}
+
+/** Number of payloads whose checksums are hashed per SHA256D_short call. */
+static constexpr size_t BASE58CHECK_BATCH = 64;
+
+void EncodeBase58Check(std::span<const std::array<unsigned char, 21>> inputs,
+                       std::span<std::array<char, BASE58CHECK_21_MAX_SIZE>> out,
+                       std::span<size_t> lengths)
+{
+    assert(out.size() == inputs.size() && lengths.size() == inputs.size());
+    const unsigned char* messages[BASE58CHECK_BATCH];
+    size_t sizes[BASE58CHECK_BATCH];
+    unsigned char hashes[BASE58CHECK_BATCH][CSHA256::OUTPUT_SIZE];
+    for (size_t done = 0; done < inputs.size(); done += BASE58CHECK_BATCH) {
+        const size_t n = std::min(BASE58CHECK_BATCH, inputs.size() - done);
+        for (size_t i = 0; i < n; ++i) {
+            messages[i] = inputs[done + i].data();
+            sizes[i] = 21;
+        }
+        SHA256D_short(hashes[0], messages, sizes, n);
+        for (size_t i = 0; i < n; ++i) {
+            unsigned char buf[25];
+            std::copy(inputs[done + i].begin(), inputs[done + i].end(), buf);
+            memcpy(buf + 21, hashes[i], 4);
+            lengths[done + i] = EncodeBase58Fixed<25, BASE58CHECK_21_MAX_SIZE>(buf, out[done + i].data());
+        }
+    }
+}
+
+size_t DecodeBase58Check(std::span<const std::string_view> strs,
+                         std::span<std::array<unsigned char, 21>> out,
+                         std::span<bool> valid)
+{
+    assert(out.size() == strs.size() && valid.size() == strs.size());
+    unsigned char decoded[BASE58CHECK_BATCH][25];
+    const unsigned char* messages[BASE58CHECK_BATCH];
+    size_t sizes[BASE58CHECK_BATCH];
+    size_t index[BASE58CHECK_BATCH];
+    unsigned char hashes[BASE58CHECK_BATCH][CSHA256::OUTPUT_SIZE];
+    size_t count = 0;
+    for (size_t done = 0; done < strs.size(); done += BASE58CHECK_BATCH) {
+        const size_t n = std::min(BASE58CHECK_BATCH, strs.size() - done);
+        // 只有 Base58 解码成功的才需要计算校验和
+        size_t m = 0;
+        for (size_t i = 0; i < n; ++i) {
+            valid[done + i] = false;
+            if (DecodeBase58Fixed<25>(strs[done + i], decoded[m])) {
+                messages[m] = decoded[m];
+                sizes[m] = 21;
+                index[m++] = done + i;
+            }
+        }
+        SHA256D_short(hashes[0], messages, sizes, m);
+        for (size_t i = 0; i < m; ++i) {
+            if (memcmp(hashes[i], decoded[i] + 21, 4) == 0) {
+                std::copy(decoded[i], decoded[i] + 21, out[index[i]].begin());
+                valid[index[i]] = true;
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
 [[nodiscard]] static bool DecodeBase58Check(const char* psz, std::vector<unsigned char>& vchRet, int max_ret_len)
 {
     if (!DecodeBase58(psz, vchRet, max_ret_len > std::numeric_limits<int>::max() - 4 ? std::numeric_limits<int>::max() : max_ret_len + 4) ||
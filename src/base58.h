@@ -16,7 +16,9 @@
 
 #include "span.h"
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -35,10 +37,49 @@ std::string EncodeBase58(std::span<const unsigned char> input);
  */
 std::string EncodeBase58Check(std::span<const unsigned char> input);
 
+/** Largest Base58Check encodings of a 21-byte payload (a Tron address) and a
+ *  78-byte payload (a BIP32 extended key). Tron addresses always take 34
+ *  characters and mainnet extended keys 111. */
+constexpr size_t BASE58CHECK_21_MAX_SIZE = 35;
+constexpr size_t BASE58CHECK_78_MAX_SIZE = 112;
+
+/**
+ * Encode a fixed-size payload plus its checksum into the caller's buffer
+ * without allocating. Return the number of characters written.
+ */
+size_t EncodeBase58Check(std::span<const unsigned char, 21> input, std::span<char, BASE58CHECK_21_MAX_SIZE> out);
+size_t EncodeBase58Check(std::span<const unsigned char, 78> input, std::span<char, BASE58CHECK_78_MAX_SIZE> out);
+
 /**
  * Decode a base58-encoded string (str) that includes a checksum into a byte
  * vector (vchRet), return true if decoding is successful
  */
 [[nodiscard]] bool DecodeBase58Check(const std::string& str, std::vector<unsigned char>& vchRet, int max_ret_len);
 
+/**
+ * Decode a Base58Check string that must carry a fixed-size payload into out,
+ * without allocating. Return false if str is not valid Base58, does not
+ * decode to exactly the payload plus a 4-byte checksum, or the checksum does
+ * not match. Leading and trailing spaces are skipped, as above.
+ */
+[[nodiscard]] bool DecodeBase58Check(std::string_view str, std::span<unsigned char, 21> out);
+[[nodiscard]] bool DecodeBase58Check(std::string_view str, std::span<unsigned char, 78> out);
+
+/**
+ * Batch forms of the 21-byte encoder and decoder, for address lists. The
+ * checksums are hashed several at a time with SHA256D_short. All spans must
+ * have the same size.
+ *
+ * EncodeBase58Check writes the encoding of inputs[i] to out[i] and its
+ * length to lengths[i]. DecodeBase58Check sets valid[i] to whether strs[i]
+ * decodes, writing the payload to out[i] if so, and returns the number of
+ * valid strings.
+ */
+void EncodeBase58Check(std::span<const std::array<unsigned char, 21>> inputs,
+                       std::span<std::array<char, BASE58CHECK_21_MAX_SIZE>> out,
+                       std::span<size_t> lengths);
+size_t DecodeBase58Check(std::span<const std::string_view> strs,
+                         std::span<std::array<unsigned char, 21>> out,
+                         std::span<bool> valid);
+
 #endif // BASE58_H
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "wallet_core/batch_signer.h"
+
+#include <atomic>
+#include <stdexcept>
+
+#include "crypto/sha256.h"
+#include "curve.h"
+#include "curve_batch.h"
+#include "thread_pool.h"
+
+using namespace wallet;
+
+namespace {
+// 每个任务签名的数量，单次签名约几十微秒，足以摊薄任务调度开销
+constexpr size_t SIGN_GRAIN = 64;
+// 恢复按 CURVE_BATCH_SIZE 分组归一化，任务粒度取它的整数倍
+constexpr size_t RECOVER_GRAIN = 2 * CURVE_BATCH_SIZE;
+
+void check_sizes(size_t keys, size_t inputs, size_t out) {
+    if (keys != inputs || inputs != out) {
+        throw std::invalid_argument("Input and output sizes do not match");
+    }
+}
+
+/// Signs `out[i]` for `i` in `[begin, end)`. `key_of(i)` and `hash_of(i, buf)`
+/// return the key and the digest of item `i`.
+template <typename KeyOf, typename HashOf>
+void sign_chunk(size_t begin, size_t end, KeyOf&& key_of, HashOf&& hash_of,
+                std::span<PrivateKey::Signature> out) {
+    // 同一任务内复用本线程的上下文
+    const auto* ctx = get_secp256k1_context();
+    BatchSigner::Hash buffer;
+    for (size_t i = begin; i < end; ++i) {
+        const byte* hash = hash_of(i, buffer);
+        if (!sign_recoverable(ctx, key_of(i).data().data(), hash, out[i].data())) {
+            throw std::runtime_error("Failed to sign");
+        }
+    }
+}
+}  // namespace
+
+BatchSigner::BatchSigner(size_t threads) : pool_(std::make_unique<ThreadPool>(threads)) {}
+
+BatchSigner::~BatchSigner() = default;
+
+size_t BatchSigner::threads() const { return pool_->size(); }
+
+void BatchSigner::sign(std::span<const PrivateKey> keys, std::span<const Hash> hashes,
+                       std::span<PrivateKey::Signature> out) {
+    check_sizes(keys.size(), hashes.size(), out.size());
+    pool_->parallelFor(hashes.size(), SIGN_GRAIN, [&](size_t begin, size_t end) {
+        sign_chunk(
+            begin, end, [&](size_t i) -> const PrivateKey& { return keys[i]; },
+            [&](size_t i, Hash&) { return hashes[i].data(); }, out);
+    });
+}
+
+void BatchSigner::sign(const PrivateKey& key, std::span<const Hash> hashes,
+                       std::span<PrivateKey::Signature> out) {
+    check_sizes(hashes.size(), hashes.size(), out.size());
+    pool_->parallelFor(hashes.size(), SIGN_GRAIN, [&](size_t begin, size_t end) {
+        sign_chunk(
+            begin, end, [&](size_t) -> const PrivateKey& { return key; },
+            [&](size_t i, Hash&) { return hashes[i].data(); }, out);
+    });
+}
+
+void BatchSigner::signTransactions(std::span<const PrivateKey> keys,
+                                   std::span<const std::span<const byte>> raw_data,
+                                   std::span<PrivateKey::Signature> out) {
+    check_sizes(keys.size(), raw_data.size(), out.size());
+    pool_->parallelFor(raw_data.size(), SIGN_GRAIN, [&](size_t begin, size_t end) {
+        sign_chunk(
+            begin, end, [&](size_t i) -> const PrivateKey& { return keys[i]; },
+            [&](size_t i, Hash& buffer) {
+                CSHA256().Write(raw_data[i].data(), raw_data[i].size()).Finalize(buffer.data());
+                return buffer.data();
+            },
+            out);
+    });
+}
+
+void BatchSigner::signTransactions(const PrivateKey& key,
+                                   std::span<const std::span<const byte>> raw_data,
+                                   std::span<PrivateKey::Signature> out) {
+    check_sizes(raw_data.size(), raw_data.size(), out.size());
+    pool_->parallelFor(raw_data.size(), SIGN_GRAIN, [&](size_t begin, size_t end) {
+        sign_chunk(
+            begin, end, [&](size_t) -> const PrivateKey& { return key; },
+            [&](size_t i, Hash& buffer) {
+                CSHA256().Write(raw_data[i].data(), raw_data[i].size()).Finalize(buffer.data());
+                return buffer.data();
+            },
+            out);
+    });
+}
+
+size_t BatchSigner::recoverAddresses(std::span<const PrivateKey::Signature> sigs,
+                                     std::span<const Hash> hashes,
+                                     std::span<tron::TronAddress::Data> out,
+                                     std::span<bool> valid) {
+    if (sigs.size() != hashes.size() || sigs.size() != out.size() || sigs.size() != valid.size()) {
+        throw std::invalid_argument("Output size does not match the number of signatures");
+    }
+    std::atomic<size_t> count{0};
+    pool_->parallelFor(sigs.size(), RECOVER_GRAIN, [&](size_t begin, size_t end) {
+        const size_t n = end - begin;
+        count += tron::TronAddress::recover_addresses(sigs.subspan(begin, n), hashes.subspan(begin, n),
+                                                      out.subspan(begin, n), valid.subspan(begin, n));
+    });
+    return count;
+}
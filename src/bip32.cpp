@@ -1,9 +1,14 @@
 #include "bip32.h"
+#include <algorithm>
 #include <stdexcept>
+#include <utility>
 
+#include "base58.h"
 #include "crypto/common.h"
 #include "crypto/hmac_sha512.h"
 #include "curve.h"
+#include "curve_batch.h"
+#include "hash.h"
 #include "secp256k1.h"
 
 using namespace wallet;
@@ -22,21 +27,112 @@ HDNode HDNode::fromSeed(const std::array<byte, 64>& seed) {
     return node;
 }
 
+HDNode HDNode::deserialize(const std::string& extended, uint32_t* parent_fingerprint,
+                           bool* is_private) {
+    std::array<unsigned char, 78> buf;
+    if (!DecodeBase58Check(extended, buf)) {
+        throw std::runtime_error("Invalid extended key encoding");
+    }
+    const byte* ptr = buf.data();
+    bool is_public;
+    uint32_t version = ReadBE32(ptr);
+    ptr += 4;
+    if (version == 0x0488B21E) {
+        // 扩展公钥
+        is_public = true;
+    } else if (version == 0x0488ADE4) {
+        // 扩展私钥
+        is_public = false;
+    } else {
+        throw std::runtime_error("Unknown extended key version");
+    }
+    HDNode node = {};
+    node.depth = *ptr++;
+    if (parent_fingerprint) {
+        *parent_fingerprint = ReadBE32(ptr);
+    }
+    ptr += 4;
+    node.child_num = ReadBE32(ptr);
+    ptr += 4;
+    std::copy(ptr, ptr + 32, node.chain_code.begin());
+    ptr += 32;
+    if (is_public) {
+        std::copy(ptr, ptr + 33, node.public_key_data);
+        // 解码时即解析公钥，后续派生不再重复解析
+        if (!secp256k1_ec_pubkey_parse(get_secp256k1_context(), &node.public_key_point,
+                                       node.public_key_data, sizeof(node.public_key_data))) {
+            throw std::runtime_error("Invalid extended public key");
+        }
+        node.has_public_key_point = true;
+    } else {
+        if (*ptr++ != 0x00) {
+            throw std::runtime_error("Invalid extended private key");
+        }
+        std::copy(ptr, ptr + 32, node.private_key_data);
+    }
+    if (is_private) {
+        *is_private = !is_public;
+    }
+    return node;
+}
+
+std::string HDNode::serialize(uint32_t parent_fingerprint, bool use_public) const {
+    std::array<byte, 78> buf;
+    byte* ptr = buf.data();
+    // 4字节版本号
+    WriteBE32(ptr, use_public ? 0x0488B21E : 0x0488ADE4);
+    ptr += 4;
+    // 1字节的深度
+    *ptr++ = depth;
+    // 4字节的父节点指纹
+    WriteBE32(ptr, parent_fingerprint);
+    ptr += 4;
+    // 4字节的子节点编号
+    WriteBE32(ptr, child_num);
+    ptr += 4;
+    // 32字节的链码
+    std::copy(chain_code.begin(), chain_code.end(), ptr);
+    ptr += 32;
+    if (use_public) {
+        // 填充33字节公钥
+        std::copy(std::begin(public_key_data), std::end(public_key_data), ptr);
+    } else {
+        // 填充0x00 || ser256(k)
+        *ptr++ = 0;
+        std::copy(std::begin(private_key_data), std::end(private_key_data), ptr);
+    }
+    char out[BASE58CHECK_78_MAX_SIZE];
+    return std::string(out, EncodeBase58Check(buf, out));
+}
+
+uint32_t HDNode::fingerprint() {
+    fillPublicKey();
+    std::array<byte, CHash160::OUTPUT_SIZE> digest;
+    CHash160().Write(public_key_data).Finalize(digest);
+    return ReadBE32(digest.data());
+}
+
 void HDNode::fillPublicKey() {
     if (public_key_data[0] != 0) { 
         return; 
     }
-    secp256k1_pubkey pub;
-    auto ctx = get_secp256k1_context();
-    if (!secp256k1_ec_pubkey_create(ctx, &pub, private_key_data)) {
-        throw std::runtime_error("Failed to create public key");
-    }
     size_t out_len = PUBLIC_KEY_LEN;
-    if (!secp256k1_ec_pubkey_serialize(ctx, public_key_data, &out_len, &pub, SECP256K1_EC_COMPRESSED)) {
+    if (!secp256k1_ec_pubkey_serialize(get_secp256k1_context(), public_key_data, &out_len,
+                                       &publicKeyPoint(), SECP256K1_EC_COMPRESSED)) {
         throw std::runtime_error("Failed to serialize public key");
     }
 }
 
+const secp256k1_pubkey& HDNode::publicKeyPoint() {
+    if (!has_public_key_point) {
+        if (!secp256k1_ec_pubkey_create(get_secp256k1_context(), &public_key_point, private_key_data)) {
+            throw std::runtime_error("Failed to create public key");
+        }
+        has_public_key_point = true;
+    }
+    return public_key_point;
+}
+
 
 HDNode::PrivateKey HDNode::privateKey() const {
     std::array<byte, 32> result;
@@ -51,26 +147,59 @@ HDNode::PublicKey HDNode::publicKey() const {
 }
 
 HDNode HDNode::privateCkd(uint32_t index) {
-    auto ctx = get_secp256k1_context();
+    if (!(index & 0x80000000)) {
+        fillPublicKey();
+    }
+    return CkdContext(*this).privateCkd(index);
+}
+
+HDNode HDNode::publicCkd(uint32_t index) const {
+    return CkdContext(*this).publicCkd(index);
+}
+
+CkdContext::CkdContext(const HDNode& parent)
+    : parent_(parent), keyed_(parent.chain_code.data(), parent.chain_code.size()) {
+    // 公钥派生得到的节点只有点没有字节，这里序列化一次供 HMAC 使用（无需求逆）
+    if (parent_.has_public_key_point) {
+        parent_.fillPublicKey();
+    }
+}
+
+void CkdContext::hmac(uint32_t index, byte hash[64]) const {
     std::array<uint8_t, 37> data;
     if (index & 0x80000000) {
         // Hardened: data = 0x00 || parent_privkey || i
         data[0] = 0;
-        std::copy(std::begin(private_key_data), std::end(private_key_data), data.begin() + 1);
+        std::copy(std::begin(parent_.private_key_data), std::end(parent_.private_key_data), data.begin() + 1);
     } else {
         // Normal: data = parent_pubkey || i
-        fillPublicKey();
-        std::copy(std::begin(public_key_data), std::end(public_key_data), data.begin());
+        std::copy(std::begin(parent_.public_key_data), std::end(parent_.public_key_data), data.begin());
     }
     WriteBE32(data.data() + 33, index);
-    byte hash[64];
-    CHMAC_SHA512 hmac(chain_code.data(), chain_code.size());
+    // 复制已压缩过密钥填充块的状态，每个子节点只需处理自身的 37 字节消息
+    CHMAC_SHA512 hmac = keyed_;
     hmac.Write(data.data(), data.size()).Finalize(hash);
+}
+
+HDNode CkdContext::privateCkd(uint32_t index) {
+    if (!(index & 0x80000000)) {
+        parent_.fillPublicKey();
+    }
+    return std::as_const(*this).privateCkd(index);
+}
+
+HDNode CkdContext::privateCkd(uint32_t index) const {
+    if (!(index & 0x80000000) && parent_.public_key_data[0] == 0) {
+        throw std::runtime_error("Parent public key is not available");
+    }
+    auto ctx = get_secp256k1_context();
+    byte hash[64];
+    hmac(index, hash);
     std::array<byte, 32> il;
     std::array<byte, 32> ir;
     std::copy(hash, hash + 32, il.begin());
     std::copy(hash + 32, hash + 64, ir.begin());
-    auto child_key = privateKey();
+    auto child_key = parent_.privateKey();
     if (!secp256k1_ec_seckey_verify(ctx, il.data())) {
         throw std::runtime_error("Invalid derived key (il)");
     }
@@ -80,24 +209,18 @@ HDNode HDNode::privateCkd(uint32_t index) {
     HDNode out;
     std::copy(child_key.begin(),child_key.end(), out.private_key_data);
     out.chain_code = std::move(ir);
-    out.depth = depth + 1;
+    out.depth = parent_.depth + 1;
     out.child_num = index;
     std::memset(out.public_key_data, 0, sizeof(out.public_key_data));
     return out;
 }
 
-
-HDNode HDNode::publicCkd(uint32_t index) {
+HDNode CkdContext::publicCkd(uint32_t index) const {
     if (index & 0x80000000) {
         throw std::runtime_error("Public derivation does not support hardened indexes");
     }
-    std::array<uint8_t, 37> data;
-    std::copy(std::begin(public_key_data), std::end(public_key_data), data.begin());
-    WriteBE32(data.data() + 33, index);
-
     byte hash[64];
-    CHMAC_SHA512 hmac(chain_code.data(), chain_code.size());
-    hmac.Write(data.data(), data.size()).Finalize(hash);
+    hmac(index, hash);
 
     std::array<byte, 32> il, ir;
     std::copy(hash, hash + 32, il.begin());
@@ -107,27 +230,81 @@ HDNode HDNode::publicCkd(uint32_t index) {
         throw std::runtime_error("Invalid IL value");
     }
 
-    secp256k1_pubkey pubkey;
-    if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, public_key_data, sizeof(public_key_data))) {
-        throw std::runtime_error("Failed to parse public key");
-    }
-
-    if (!secp256k1_ec_pubkey_tweak_add(ctx, &pubkey, il.data())) {
+    HDNode out;
+    out.public_key_point = parentPoint();
+    if (!secp256k1_ec_pubkey_tweak_add(ctx, &out.public_key_point, il.data())) {
         throw std::runtime_error("Public key tweak failed");
     }
-
-    size_t out_len = 33;
-    std::array<uint8_t, 33> out_pubkey;
-    if (!secp256k1_ec_pubkey_serialize(ctx, out_pubkey.data(), &out_len, &pubkey, SECP256K1_EC_COMPRESSED)) {
-        throw std::runtime_error("Failed to serialize tweaked public key");
-    }
-
-    HDNode out;
-    std::copy(out_pubkey.begin(), out_pubkey.end(), out.public_key_data);
+    out.has_public_key_point = true;
+    std::memset(out.public_key_data, 0, sizeof(out.public_key_data));
     out.chain_code = std::move(ir);
-    out.depth = depth + 1;
+    out.depth = parent_.depth + 1;
     out.child_num = index;
     std::memset(out.private_key_data, 0, sizeof(out.private_key_data));
     return out;
 }
 
+const secp256k1_pubkey& CkdContext::parentPoint() const {
+    if (!parent_.has_public_key_point) {
+        throw std::runtime_error("Parent public key is not available");
+    }
+    return parent_.public_key_point;
+}
+
+void CkdContext::publicCkdBatch(uint32_t start, std::span<secp256k1_pubkey> out) const {
+    if (start & 0x80000000 || out.size() > 0x80000000 - uint64_t{start}) {
+        throw std::runtime_error("Public derivation does not support hardened indexes");
+    }
+    auto ctx = get_secp256k1_context();
+    const secp256k1_pubkey& parent = parentPoint();
+    static const size_t DATA_LEN = HDNode::PUBLIC_KEY_LEN + 4;
+    byte data[DATA_LEN * CURVE_BATCH_SIZE];
+    byte hashes[CHMAC_SHA512::OUTPUT_SIZE * CURVE_BATCH_SIZE];
+    byte tweaks[32 * CURVE_BATCH_SIZE];
+    for (size_t done = 0; done < out.size(); done += CURVE_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(CURVE_BATCH_SIZE, out.size() - done);
+        for (size_t i = 0; i < count; ++i) {
+            std::copy(std::begin(parent_.public_key_data), std::end(parent_.public_key_data), data + DATA_LEN * i);
+            WriteBE32(data + DATA_LEN * i + 33, start + static_cast<uint32_t>(done + i));
+        }
+        // 兄弟节点的 HMAC 消息并行计算（多路 SHA-512）
+        keyed_.FinalizeMany(data, DATA_LEN, count, hashes);
+        for (size_t i = 0; i < count; ++i) {
+            const byte* il = hashes + CHMAC_SHA512::OUTPUT_SIZE * i;
+            if (!secp256k1_ec_seckey_verify(ctx, il)) {
+                throw std::runtime_error("Invalid IL value");
+            }
+            std::copy(il, il + 32, tweaks + 32 * i);
+        }
+        if (!curve_pubkey_tweak_add_batch(ctx, out.data() + done, &parent, tweaks, count)) {
+            throw std::runtime_error("Public key tweak failed");
+        }
+    }
+}
+
+void CkdContext::publicCkdBatch(uint32_t start, std::span<HDNode::PublicKey> out) const {
+    auto ctx = get_secp256k1_context();
+    secp256k1_pubkey keys[CURVE_BATCH_SIZE];
+    for (size_t done = 0; done < out.size(); done += CURVE_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(CURVE_BATCH_SIZE, out.size() - done);
+        publicCkdBatch(start + static_cast<uint32_t>(done), std::span(keys, count));
+        for (size_t i = 0; i < count; ++i) {
+            size_t out_len = HDNode::PUBLIC_KEY_LEN;
+            if (!secp256k1_ec_pubkey_serialize(ctx, out[done + i].data(), &out_len, &keys[i],
+                                               SECP256K1_EC_COMPRESSED)) {
+                throw std::runtime_error("Failed to serialize public key");
+            }
+        }
+    }
+}
+
+CkdContext wallet::deriveRangeParent(const std::string& extended, uint32_t change,
+                                     uint32_t start, size_t count) {
+    if (change & 0x80000000 || count > 0x80000000 - uint64_t{start}) {
+        throw std::invalid_argument("Range exceeds the non-hardened index space");
+    }
+    auto node = HDNode::deserialize(extended);
+    // 扩展私钥同样走公钥派生，地址公钥与私钥派生的结果一致
+    node.fillPublicKey();
+    return CkdContext(node.publicCkd(change));
+}
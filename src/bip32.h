@@ -4,6 +4,10 @@
 #include <vector>
 #include <array>
 #include <optional>
+#include <span>
+#include <string>
+#include "crypto/hmac_sha512.h"
+#include "secp256k1.h"
 #include "wallet_core/base.h"
 
 namespace wallet {
@@ -16,18 +20,86 @@ struct HDNode {
     using PrivateKey = std::array<byte, PRIVATE_KEY_LEN>;
     using PublicKey = std::array<byte, PUBLIC_KEY_LEN>;
     byte private_key_data[PRIVATE_KEY_LEN];
+    /// Compressed public key; all zero until filled in.
     byte public_key_data[PUBLIC_KEY_LEN];
+    /// Parsed public key, kept alongside the bytes so that derivation does
+    /// not have to parse them back (a square root) or serialize children
+    /// nobody asks the bytes of. Whenever the bytes are filled in, so is
+    /// this.
+    secp256k1_pubkey public_key_point;
+    bool has_public_key_point = false;
     ChainCode chain_code;
     uint32_t depth;
     uint32_t child_num;
     static HDNode fromSeed(const std::array<byte, 64>& seed);
+    /// Decodes a Base58Check `xpub`/`xprv` string. The parent fingerprint,
+    /// which the node does not keep, is written to `parent_fingerprint` if
+    /// given, and whether the key is private to `is_private`.
+    ///
+    /// \throws std::runtime_error if the string is not a valid extended key.
+    static HDNode deserialize(const std::string& extended, uint32_t* parent_fingerprint = nullptr,
+                              bool* is_private = nullptr);
+    /// Encodes the node as an `xpub` (whose public key must be filled in) or
+    /// `xprv` string.
+    std::string serialize(uint32_t parent_fingerprint, bool use_public) const;
+    /// First four bytes of the HASH160 of the public key, which is filled in.
+    uint32_t fingerprint();
+    /// Fills in `public_key_data`, from the point if there is one.
     void fillPublicKey();
+    /// Returns the public key point, computing it from the private key if
+    /// needed but leaving the bytes alone.
+    const secp256k1_pubkey& publicKeyPoint();
     PrivateKey privateKey() const;
     PublicKey publicKey() const;
     HDNode privateCkd(uint32_t child);
-    HDNode publicCkd(uint32_t child);
+    HDNode publicCkd(uint32_t child) const;
 };
 
+/// Derives the children of one parent node.
+///
+/// Every child's HMAC-SHA512 is keyed with the parent's chain code, so the
+/// context compresses the inner and outer key pad blocks once up front and
+/// each child then only hashes its own 37-byte message and the outer digest.
+/// Keep one around whenever several siblings are derived. The const methods
+/// may be called concurrently.
+class CkdContext {
+public:
+    explicit CkdContext(const HDNode& parent);
+
+    const HDNode& node() const { return parent_; }
+
+    /// Fills in the parent's public key first if `child` is not hardened.
+    HDNode privateCkd(uint32_t child);
+    /// The parent's public key must already be filled in if `child` is not
+    /// hardened.
+    HDNode privateCkd(uint32_t child) const;
+    /// The parent must carry its public key. The child carries only the
+    /// point; its bytes are filled in on demand.
+    HDNode publicCkd(uint32_t child) const;
+    /// Derives the public keys of the non-hardened children `start`,
+    /// `start + 1`, ... into `out`. The children's points are normalized in
+    /// batches sharing one field inversion, and their chain codes are not
+    /// computed.
+    void publicCkdBatch(uint32_t start, std::span<secp256k1_pubkey> out) const;
+    /// Same as above, writing the children's compressed public keys.
+    void publicCkdBatch(uint32_t start, std::span<HDNode::PublicKey> out) const;
+
+private:
+    void hmac(uint32_t child, byte hash[CHMAC_SHA512::OUTPUT_SIZE]) const;
+    const secp256k1_pubkey& parentPoint() const;
+
+    HDNode parent_;
+    CHMAC_SHA512 keyed_;
+};
+
+/// Decodes an account-level extended key and derives its `change` node, the
+/// common parent of the addresses `[start, start + count)`. Extended private
+/// keys are handled through their public key, which yields the same children.
+///
+/// \throws std::invalid_argument if the range leaves the non-hardened index
+/// space.
+CkdContext deriveRangeParent(const std::string& extended, uint32_t change, uint32_t start, size_t count);
+
 }
 
 
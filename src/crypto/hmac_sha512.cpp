@@ -4,6 +4,10 @@
 
 #include "hmac_sha512.h"
 
+#include "crypto/common.h"
+
+#include <algorithm>
+#include <cassert>
 #include <cstring>
 
 CHMAC_SHA512::CHMAC_SHA512(const unsigned char* key, size_t keylen)
@@ -31,4 +35,50 @@ void CHMAC_SHA512::Finalize(unsigned char hash[OUTPUT_SIZE])
     unsigned char temp[64];
     inner.Finalize(temp);
     outer.Write(temp, 64).Finalize(hash);
-}
\ No newline at end of file
+}
+namespace
+{
+/** Pad the final block of a message of len bytes that follows one 128-byte
+ *  block: the 0x80 terminator, zeros and the 128-bit message length. */
+void PadBlock(unsigned char block[128], size_t len)
+{
+    block[len] = 0x80;
+    memset(block + len + 1, 0, 120 - len - 1);
+    WriteBE64(block + 120, (128 + len) << 3);
+}
+} // namespace
+
+void CHMAC_SHA512::FinalizeMany(const unsigned char* data, size_t len, size_t n, unsigned char* out) const
+{
+    assert(len <= MAX_BATCH_MESSAGE);
+    // Enough lanes for the widest transform, several times over.
+    static const size_t BATCH = 32;
+    uint64_t inner_state[8], outer_state[8];
+    inner.Midstate(inner_state);
+    outer.Midstate(outer_state);
+
+    uint64_t states[8 * BATCH];
+    unsigned char blocks[128 * BATCH];
+    for (size_t done = 0; done < n; done += BATCH) {
+        const size_t count = std::min(BATCH, n - done);
+        for (size_t i = 0; i < count; ++i) {
+            memcpy(blocks + 128 * i, data + len * (done + i), len);
+            PadBlock(blocks + 128 * i, len);
+            std::copy(inner_state, inner_state + 8, states + 8 * i);
+        }
+        SHA512TransformMany(states, blocks, count);
+        for (size_t i = 0; i < count; ++i) {
+            for (int j = 0; j < 8; ++j) {
+                WriteBE64(blocks + 128 * i + 8 * j, states[8 * i + j]);
+            }
+            PadBlock(blocks + 128 * i, OUTPUT_SIZE);
+            std::copy(outer_state, outer_state + 8, states + 8 * i);
+        }
+        SHA512TransformMany(states, blocks, count);
+        for (size_t i = 0; i < count; ++i) {
+            for (int j = 0; j < 8; ++j) {
+                WriteBE64(out + OUTPUT_SIZE * (done + i) + 8 * j, states[8 * i + j]);
+            }
+        }
+    }
+}
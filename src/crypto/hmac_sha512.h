@@ -27,6 +27,16 @@ public:
         return *this;
     }
     void Finalize(unsigned char hash[OUTPUT_SIZE]);
+
+    /** Compute the HMACs of n messages of len bytes each under this object's
+     *  key, hashing them side by side with SHA512TransformMany. Nothing may
+     *  have been written yet, and len must be at most MAX_BATCH_MESSAGE so
+     *  that each message fits in a single block.
+     *  data: pointer to n consecutive messages
+     *  out:  pointer to an n*OUTPUT_SIZE byte output buffer
+     */
+    void FinalizeMany(const unsigned char* data, size_t len, size_t n, unsigned char* out) const;
+    static const size_t MAX_BATCH_MESSAGE = 111;
 };
 
 #endif // CRYPTO_HMAC_SHA512_H
\ No newline at end of file
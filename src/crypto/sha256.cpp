@@ -32,11 +32,13 @@ void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
 namespace sha256d64_sse41
 {
 void Transform_4way(unsigned char* out, const unsigned char* in);
+void TransformShort_4way(unsigned char* out, const unsigned char* in, size_t blocks);
 }
 
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
+void TransformShort_8way(unsigned char* out, const unsigned char* in, size_t blocks);
 }
 
 namespace sha256d64_x86_shani
@@ -483,6 +485,40 @@ TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
 
+typedef void (*TransformShortType)(unsigned char*, const unsigned char*, size_t);
+TransformShortType TransformShort_4way = nullptr;
+TransformShortType TransformShort_8way = nullptr;
+
+/** Pad a message of at most SHA256D_SHORT_MAX_SIZE bytes into blocks * 64 bytes at out. */
+void PadShort(unsigned char* out, const unsigned char* in, size_t len, size_t blocks)
+{
+    std::copy(in, in + len, out);
+    out[len] = 0x80;
+    std::fill(out + len + 1, out + 64 * blocks - 8, 0);
+    WriteBE64(out + 64 * blocks - 8, len << 3);
+}
+
+size_t ShortBlocks(size_t len) { return (len + 9 + 63) / 64; }
+
+/** Double-SHA256 of one padded short message with the 1-way transform. */
+void TransformShort(unsigned char* out, const unsigned char* in, size_t blocks)
+{
+    uint32_t s[8];
+    unsigned char buffer[64] = {};
+    sha256::Initialize(s);
+    Transform(s, in, blocks);
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(buffer + 4 * i, s[i]);
+    }
+    buffer[32] = 0x80;
+    WriteBE64(buffer + 56, 256);
+    sha256::Initialize(s);
+    Transform(s, buffer, 1);
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(out + 4 * i, s[i]);
+    }
+}
+
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
     static const uint32_t init[8] = {
@@ -565,6 +601,38 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test the short-message kernels, if available: first on the 64-byte
+    // messages above (two blocks once padded), then on one-block messages
+    // against the 1-way transform.
+    if (TransformShort_4way || TransformShort_8way) {
+        unsigned char padded[8 * 128];
+        for (int i = 0; i < 8; ++i) {
+            PadShort(padded + 128 * i, data + 1 + 64 * i, 64, 2);
+        }
+        unsigned char out[256];
+        if (TransformShort_4way) {
+            TransformShort_4way(out, padded, 2);
+            if (!std::equal(out, out + 128, result_d64)) return false;
+        }
+        if (TransformShort_8way) {
+            TransformShort_8way(out, padded, 2);
+            if (!std::equal(out, out + 256, result_d64)) return false;
+        }
+        unsigned char expected[256];
+        for (int i = 0; i < 8; ++i) {
+            PadShort(padded + 64 * i, data + 1 + 7 * i, 21 + i, 1);
+            TransformShort(expected + 32 * i, padded + 64 * i, 1);
+        }
+        if (TransformShort_4way) {
+            TransformShort_4way(out, padded, 1);
+            if (!std::equal(out, out + 128, expected)) return false;
+        }
+        if (TransformShort_8way) {
+            TransformShort_8way(out, padded, 1);
+            if (!std::equal(out, out + 256, expected)) return false;
+        }
+    }
+
     return true;
 }
 
@@ -579,6 +647,10 @@ bool AVXEnabled()
 }
 #endif
 #endif // DISABLE_OPTIMIZED_SHA256
+
+// The scalar transform is used until detection has run, so hashing during
+// static initialization elsewhere is still correct.
+[[maybe_unused]] const std::string g_sha256_implementation = SHA256AutoDetect();
 } // namespace
 
 
@@ -590,6 +662,8 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     TransformD64_2way = nullptr;
     TransformD64_4way = nullptr;
     TransformD64_8way = nullptr;
+    TransformShort_4way = nullptr;
+    TransformShort_8way = nullptr;
 
 #if !defined(DISABLE_OPTIMIZED_SHA256)
 #if defined(HAVE_GETCPUID)
@@ -626,6 +700,13 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
         TransformD64 = TransformD64Wrapper<sha256_x86_shani::Transform>;
         TransformD64_2way = sha256d64_x86_shani::Transform_2way;
         ret = "x86_shani(1way,2way)";
+#if defined(ENABLE_AVX2)
+        // Batches of short messages still go faster eight at a time.
+        if (have_avx2 && have_avx && enabled_avx) {
+            TransformShort_8way = sha256d64_avx2::TransformShort_8way;
+            ret += ",avx2(8way short)";
+        }
+#endif
         have_sse4 = false; // Disable SSE4/AVX2;
         have_avx2 = false;
     }
@@ -639,6 +720,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
 #endif
 #if defined(ENABLE_SSE41)
         TransformD64_4way = sha256d64_sse41::Transform_4way;
+        TransformShort_4way = sha256d64_sse41::TransformShort_4way;
         ret += ",sse41(4way)";
 #endif
     }
@@ -646,6 +728,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
 #if defined(ENABLE_AVX2)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformShort_8way = sha256d64_avx2::TransformShort_8way;
         ret += ",avx2(8way)";
     }
 #endif
@@ -778,4 +861,38 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         in += 64;
         --blocks;
     }
+}
+
+void SHA256D_short(unsigned char* out, const unsigned char* const* inputs, const size_t* lengths, size_t n)
+{
+    unsigned char padded[8 * 128];
+    while (n) {
+        // The SIMD kernels need every lane to have the same number of blocks.
+        const size_t blocks = ShortBlocks(lengths[0]);
+        size_t run = 1;
+        while (run < n && run < 8 && ShortBlocks(lengths[run]) == blocks) {
+            ++run;
+        }
+        size_t ways = 1;
+        if (TransformShort_8way && run == 8) {
+            ways = 8;
+        } else if (TransformShort_4way && run >= 4) {
+            ways = 4;
+        }
+        for (size_t i = 0; i < ways; ++i) {
+            assert(lengths[i] <= SHA256D_SHORT_MAX_SIZE);
+            PadShort(padded + 64 * blocks * i, inputs[i], lengths[i], blocks);
+        }
+        if (ways == 8) {
+            TransformShort_8way(out, padded, blocks);
+        } else if (ways == 4) {
+            TransformShort_4way(out, padded, blocks);
+        } else {
+            TransformShort(out, padded, blocks);
+        }
+        out += 32 * ways;
+        inputs += ways;
+        lengths += ways;
+        n -= ways;
+    }
 }
\ No newline at end of file
@@ -50,4 +50,17 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Longest message SHA256D_short accepts: two blocks once padded. */
+constexpr size_t SHA256D_SHORT_MAX_SIZE = 119;
+
+/** Compute multiple double-SHA256's of short messages, such as Base58Check
+ *  payloads. Runs of messages that pad to the same number of blocks are
+ *  hashed several at a time.
+ *  output:  pointer to a n*32 byte output buffer
+ *  inputs:  the n messages
+ *  lengths: their lengths, each at most SHA256D_SHORT_MAX_SIZE
+ *  n:       the number of hashes to compute.
+ */
+void SHA256D_short(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t n);
+
 #endif // CRYPTO_SHA256_H
\ No newline at end of file
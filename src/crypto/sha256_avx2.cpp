@@ -0,0 +1,184 @@
+// Copyright (c) 2018-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+namespace sha256d64_avx2 {
+namespace {
+
+const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z) { return Add(Add(x, y), z); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z, __m256i w) { return Add(Add(x, y), Add(z, w)); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z, __m256i w, __m256i v) { return Add(Add(x, y, z), Add(w, v)); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Xor(__m256i x, __m256i y, __m256i z) { return Xor(Xor(x, y), z); }
+__m256i inline Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+__m256i inline ShR(__m256i x, int n) { return _mm256_srli_epi32(x, n); }
+__m256i inline ShL(__m256i x, int n) { return _mm256_slli_epi32(x, n); }
+__m256i inline RotR(__m256i x, int n) { return Or(ShR(x, n), ShL(x, 32 - n)); }
+
+__m256i inline Ch(__m256i x, __m256i y, __m256i z) { return Xor(z, And(x, Xor(y, z))); }
+__m256i inline Maj(__m256i x, __m256i y, __m256i z) { return Or(And(x, y), And(z, Or(x, y))); }
+__m256i inline Sigma0(__m256i x) { return Xor(RotR(x, 2), RotR(x, 13), RotR(x, 22)); }
+__m256i inline Sigma1(__m256i x) { return Xor(RotR(x, 6), RotR(x, 11), RotR(x, 25)); }
+__m256i inline sigma0(__m256i x) { return Xor(RotR(x, 7), RotR(x, 18), ShR(x, 3)); }
+__m256i inline sigma1(__m256i x) { return Xor(RotR(x, 17), RotR(x, 19), ShR(x, 10)); }
+
+/** Word i of each lane's input, in big-endian order. Lane j starts at
+ *  in + j * stride. */
+__m256i inline Read(const unsigned char* in, size_t stride, int i)
+{
+    return _mm256_set_epi32(ReadBE32(in + 7 * stride + 4 * i), ReadBE32(in + 6 * stride + 4 * i), ReadBE32(in + 5 * stride + 4 * i), ReadBE32(in + 4 * stride + 4 * i),
+                            ReadBE32(in + 3 * stride + 4 * i), ReadBE32(in + 2 * stride + 4 * i), ReadBE32(in + stride + 4 * i), ReadBE32(in + 4 * i));
+}
+
+/** Store word i of each lane's 32-byte output, in big-endian order. */
+void inline Write(unsigned char* out, int i, __m256i x)
+{
+    alignas(32) uint32_t lanes[8];
+    _mm256_store_si256((__m256i*)lanes, x);
+    WriteBE32(out + 4 * i, lanes[0]);
+    WriteBE32(out + 32 + 4 * i, lanes[1]);
+    WriteBE32(out + 64 + 4 * i, lanes[2]);
+    WriteBE32(out + 96 + 4 * i, lanes[3]);
+    WriteBE32(out + 128 + 4 * i, lanes[4]);
+    WriteBE32(out + 160 + 4 * i, lanes[5]);
+    WriteBE32(out + 192 + 4 * i, lanes[6]);
+    WriteBE32(out + 224 + 4 * i, lanes[7]);
+}
+
+/** Initialize the state of each lane to the SHA-256 IV. */
+void inline Initialize(__m256i* s)
+{
+    s[0] = K(0x6a09e667ul);
+    s[1] = K(0xbb67ae85ul);
+    s[2] = K(0x3c6ef372ul);
+    s[3] = K(0xa54ff53aul);
+    s[4] = K(0x510e527ful);
+    s[5] = K(0x9b05688cul);
+    s[6] = K(0x1f83d9abul);
+    s[7] = K(0x5be0cd19ul);
+}
+
+/** Compress one message block per lane into s. The block is consumed. */
+void inline Transform(__m256i* s, __m256i* w)
+{
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int i = 0; i < 64; ++i) {
+        if (i >= 16) {
+            w[i & 15] = Add(sigma1(w[(i - 2) & 15]), w[(i - 7) & 15], sigma0(w[(i - 15) & 15]), w[i & 15]);
+        }
+        __m256i t1 = Add(h, Sigma1(e), Ch(e, f, g), K(K256[i]), w[i & 15]);
+        __m256i t2 = Add(Sigma0(a), Maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = Add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = Add(t1, t2);
+    }
+
+    s[0] = Add(s[0], a);
+    s[1] = Add(s[1], b);
+    s[2] = Add(s[2], c);
+    s[3] = Add(s[3], d);
+    s[4] = Add(s[4], e);
+    s[5] = Add(s[5], f);
+    s[6] = Add(s[6], g);
+    s[7] = Add(s[7], h);
+}
+
+/** Hash the first-round states s again as 32-byte messages and write the
+ *  results to out. The second message is the 32-byte digest plus padding
+ *  (length 256 bits). */
+void inline Finish(unsigned char* out, const __m256i* s, __m256i* w)
+{
+    __m256i t[8];
+
+    Initialize(t);
+    for (int i = 0; i < 8; ++i) {
+        w[i] = s[i];
+    }
+    w[8] = K(0x80000000ul);
+    for (int i = 9; i < 15; ++i) {
+        w[i] = K(0);
+    }
+    w[15] = K(0x100);
+    Transform(t, w);
+
+    for (int i = 0; i < 8; ++i) {
+        Write(out, i, t[i]);
+    }
+}
+
+} // namespace
+
+/** Compute 8 independent double-SHA256 hashes of 64-byte inputs.
+ *  out: 8 consecutive 32-byte hashes.
+ *  in:  8 consecutive 64-byte inputs.
+ */
+void Transform_8way(unsigned char* out, const unsigned char* in)
+{
+    __m256i s[8], w[16];
+
+    // 第一次哈希：输入块，然后是固定的填充块（长度 512 位）
+    Initialize(s);
+    for (int i = 0; i < 16; ++i) {
+        w[i] = Read(in, 64, i);
+    }
+    Transform(s, w);
+    w[0] = K(0x80000000ul);
+    for (int i = 1; i < 15; ++i) {
+        w[i] = K(0);
+    }
+    w[15] = K(0x200);
+    Transform(s, w);
+
+    Finish(out, s, w);
+}
+
+/** Compute 8 independent double-SHA256 hashes of short messages, each
+ *  already padded to the same number of 64-byte blocks.
+ *  out: 8 consecutive 32-byte hashes.
+ *  in:  8 consecutive padded messages of 64 * blocks bytes.
+ */
+void TransformShort_8way(unsigned char* out, const unsigned char* in, size_t blocks)
+{
+    __m256i s[8], w[16];
+
+    Initialize(s);
+    for (size_t b = 0; b < blocks; ++b) {
+        for (int i = 0; i < 16; ++i) {
+            w[i] = Read(in + 64 * b, 64 * blocks, i);
+        }
+        Transform(s, w);
+    }
+    Finish(out, s, w);
+}
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+// Copyright (c) 2017-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// The message schedule is computed four words at a time with SSE, following
+// Intel's "Fast SHA-256 Implementations on Intel Architecture Processors";
+// the rounds themselves stay scalar.
+
+#if defined(__x86_64__) || defined(__amd64__)
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <utility>
+
+namespace sha256_sse4 {
+namespace {
+
+alignas(16) const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+uint32_t inline RotR(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+uint32_t inline Ch(uint32_t x, uint32_t y, uint32_t z) { return z ^ (x & (y ^ z)); }
+uint32_t inline Maj(uint32_t x, uint32_t y, uint32_t z) { return (x & y) | (z & (x | y)); }
+uint32_t inline Sigma0(uint32_t x) { return RotR(x, 2) ^ RotR(x, 13) ^ RotR(x, 22); }
+uint32_t inline Sigma1(uint32_t x) { return RotR(x, 6) ^ RotR(x, 11) ^ RotR(x, 25); }
+
+/** One round with the message word and round constant already added. */
+void inline Round(uint32_t a, uint32_t b, uint32_t c, uint32_t& d, uint32_t e, uint32_t f, uint32_t g, uint32_t& h, uint32_t wk)
+{
+    uint32_t t1 = h + Sigma1(e) + Ch(e, f, g) + wk;
+    uint32_t t2 = Sigma0(a) + Maj(a, b, c);
+    d += t1;
+    h = t1 + t2;
+}
+
+__m128i inline RotR(__m128i x, int n) { return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n)); }
+__m128i inline sigma0(__m128i x) { return _mm_xor_si128(_mm_xor_si128(RotR(x, 7), RotR(x, 18)), _mm_srli_epi32(x, 3)); }
+__m128i inline sigma1(__m128i x) { return _mm_xor_si128(_mm_xor_si128(RotR(x, 17), RotR(x, 19)), _mm_srli_epi32(x, 10)); }
+
+/** Given x0..x3 = W[t-16..t-1], return W[t..t+3]. */
+__m128i inline Schedule(__m128i x0, __m128i x1, __m128i x2, __m128i x3)
+{
+    // W[t-16] + sigma0(W[t-15]) + W[t-7]
+    __m128i w = _mm_add_epi32(_mm_add_epi32(x0, sigma0(_mm_alignr_epi8(x1, x0, 4))), _mm_alignr_epi8(x3, x2, 4));
+    // W[t] 和 W[t+1] 依赖 W[t-2], W[t-1]；W[t+2], W[t+3] 依赖刚算出的 W[t], W[t+1]
+    const __m128i low = _mm_set_epi32(0, 0, -1, -1);
+    w = _mm_add_epi32(w, _mm_and_si128(sigma1(_mm_shuffle_epi32(x3, 0xFE)), low));
+    return _mm_add_epi32(w, _mm_andnot_si128(low, sigma1(_mm_shuffle_epi32(w, 0x40))));
+}
+
+} // namespace
+
+void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+    alignas(16) uint32_t wk[8];
+
+    while (blocks--) {
+        uint32_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+        __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)chunk), mask);
+        __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(chunk + 16)), mask);
+        __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(chunk + 32)), mask);
+        __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(chunk + 48)), mask);
+
+        for (int i = 0; i < 64; i += 8) {
+            _mm_store_si128((__m128i*)wk, _mm_add_epi32(x0, _mm_load_si128((const __m128i*)(K256 + i))));
+            _mm_store_si128((__m128i*)(wk + 4), _mm_add_epi32(x1, _mm_load_si128((const __m128i*)(K256 + i + 4))));
+            // 下一组消息字的计算与本组的标量轮次相互独立，可以并行执行
+            if (i < 56) {
+                x0 = Schedule(x0, x1, x2, x3);
+                x1 = Schedule(x1, x2, x3, x0);
+                std::swap(x0, x2);
+                std::swap(x1, x3);
+            }
+
+            Round(a, b, c, d, e, f, g, h, wk[0]);
+            Round(h, a, b, c, d, e, f, g, wk[1]);
+            Round(g, h, a, b, c, d, e, f, wk[2]);
+            Round(f, g, h, a, b, c, d, e, wk[3]);
+            Round(e, f, g, h, a, b, c, d, wk[4]);
+            Round(d, e, f, g, h, a, b, c, wk[5]);
+            Round(c, d, e, f, g, h, a, b, wk[6]);
+            Round(b, c, d, e, f, g, h, a, wk[7]);
+        }
+
+        s[0] += a;
+        s[1] += b;
+        s[2] += c;
+        s[3] += d;
+        s[4] += e;
+        s[5] += f;
+        s[6] += g;
+        s[7] += h;
+        chunk += 64;
+    }
+}
+}
+
+#endif
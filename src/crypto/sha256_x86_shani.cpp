@@ -0,0 +1,164 @@
+// Copyright (c) 2018-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// Based on https://github.com/noloader/SHA-Intrinsics/blob/master/sha256-x86.c,
+// written and placed in public domain by Jeffrey Walton.
+// Based on code from Intel, and by Sean Gulley for the miTLS project.
+
+#ifdef ENABLE_X86_SHANI
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+namespace {
+
+alignas(16) const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+// These are functions rather than globals: the transforms run from the
+// self-test during static initialization, possibly before this file's
+// dynamic initializers.
+__m128i inline Mask() { return _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull); }
+__m128i inline Init0() { return _mm_set_epi64x(0x6a09e667bb67ae85ull, 0x510e527f9b05688cull); }
+__m128i inline Init1() { return _mm_set_epi64x(0x3c6ef372a54ff53aull, 0x1f83d9ab5be0cd19ull); }
+
+/** Load the four message words at in, converting from big-endian. */
+__m128i inline Load(const unsigned char* in)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)in), Mask());
+}
+
+void inline Save(unsigned char* out, __m128i s)
+{
+    _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(s, Mask()));
+}
+
+/** Convert a state from a..h word order to the ABEF/CDGH order the SHA
+ *  instructions work on, and back. */
+void inline Shuffle(__m128i& s0, __m128i& s1)
+{
+    const __m128i t1 = _mm_shuffle_epi32(s0, 0xB1);
+    const __m128i t2 = _mm_shuffle_epi32(s1, 0x1B);
+    s0 = _mm_alignr_epi8(t1, t2, 0x08);
+    s1 = _mm_blend_epi16(t2, t1, 0xF0);
+}
+
+void inline Unshuffle(__m128i& s0, __m128i& s1)
+{
+    const __m128i t1 = _mm_shuffle_epi32(s0, 0x1B);
+    const __m128i t2 = _mm_shuffle_epi32(s1, 0xB1);
+    s0 = _mm_blend_epi16(t1, t2, 0xF0);
+    s1 = _mm_alignr_epi8(t2, t1, 0x08);
+}
+
+/** Run rounds 4*i .. 4*i+3 on message words m. */
+void inline QuadRound(__m128i& s0, __m128i& s1, __m128i m, int i)
+{
+    const __m128i msg = _mm_add_epi32(m, _mm_load_si128((const __m128i*)(K256 + 4 * i)));
+    s1 = _mm_sha256rnds2_epu32(s1, s0, msg);
+    s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg, 0x0e));
+}
+
+/** Compress one block into each of N shuffled states. The message words
+ *  m[j][0..3] of lane j are consumed. Interleaving the lanes hides the
+ *  latency of the round instructions. */
+template <int N>
+void inline Transform(__m128i (&s0)[N], __m128i (&s1)[N], __m128i (&m)[N][4])
+{
+    __m128i so0[N], so1[N];
+    for (int j = 0; j < N; ++j) {
+        so0[j] = s0[j];
+        so1[j] = s1[j];
+    }
+    for (int i = 0; i < 16; ++i) {
+        for (int j = 0; j < N; ++j) {
+            __m128i* w = m[j];
+            QuadRound(s0[j], s1[j], w[i & 3], i);
+            // 消息扩展：msg2 须在下一次 msg1 覆盖前完成
+            if (i >= 3 && i < 15) {
+                w[(i + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(w[(i + 1) & 3], _mm_alignr_epi8(w[i & 3], w[(i + 3) & 3], 4)), w[i & 3]);
+            }
+            if (i >= 1 && i < 13) {
+                w[(i + 3) & 3] = _mm_sha256msg1_epu32(w[(i + 3) & 3], w[i & 3]);
+            }
+        }
+    }
+    for (int j = 0; j < N; ++j) {
+        s0[j] = _mm_add_epi32(s0[j], so0[j]);
+        s1[j] = _mm_add_epi32(s1[j], so1[j]);
+    }
+}
+
+} // namespace
+
+namespace sha256_x86_shani {
+void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks)
+{
+    __m128i s0[1] = {_mm_loadu_si128((const __m128i*)s)};
+    __m128i s1[1] = {_mm_loadu_si128((const __m128i*)(s + 4))};
+    Shuffle(s0[0], s1[0]);
+
+    while (blocks--) {
+        __m128i m[1][4] = {{Load(chunk), Load(chunk + 16), Load(chunk + 32), Load(chunk + 48)}};
+        ::Transform(s0, s1, m);
+        chunk += 64;
+    }
+
+    Unshuffle(s0[0], s1[0]);
+    _mm_storeu_si128((__m128i*)s, s0[0]);
+    _mm_storeu_si128((__m128i*)(s + 4), s1[0]);
+}
+}
+
+namespace sha256d64_x86_shani {
+/** Compute 2 independent double-SHA256 hashes of 64-byte inputs.
+ *  out: 2 consecutive 32-byte hashes.
+ *  in:  2 consecutive 64-byte inputs.
+ */
+void Transform_2way(unsigned char* out, const unsigned char* in)
+{
+    // 填充块的消息字是常量：0x80 后跟长度（第一次 512 位，第二次 256 位）
+    const __m128i pad1[4] = {_mm_set_epi32(0, 0, 0, 0x80000000), _mm_setzero_si128(), _mm_setzero_si128(), _mm_set_epi32(0x200, 0, 0, 0)};
+    const __m128i pad2[2] = {_mm_set_epi32(0, 0, 0, 0x80000000), _mm_set_epi32(0x100, 0, 0, 0)};
+
+    __m128i s0[2] = {Init0(), Init0()}, s1[2] = {Init1(), Init1()};
+    __m128i m[2][4] = {
+        {Load(in), Load(in + 16), Load(in + 32), Load(in + 48)},
+        {Load(in + 64), Load(in + 80), Load(in + 96), Load(in + 112)},
+    };
+    Transform(s0, s1, m);
+    __m128i p[2][4] = {{pad1[0], pad1[1], pad1[2], pad1[3]}, {pad1[0], pad1[1], pad1[2], pad1[3]}};
+    Transform(s0, s1, p);
+
+    // 第二次哈希的输入就是第一次的摘要
+    for (int j = 0; j < 2; ++j) {
+        Unshuffle(s0[j], s1[j]);
+        m[j][0] = s0[j];
+        m[j][1] = s1[j];
+        m[j][2] = pad2[0];
+        m[j][3] = pad2[1];
+        s0[j] = Init0();
+        s1[j] = Init1();
+    }
+    Transform(s0, s1, m);
+
+    for (int j = 0; j < 2; ++j) {
+        Unshuffle(s0[j], s1[j]);
+        Save(out + 32 * j, s0[j]);
+        Save(out + 32 * j + 16, s1[j]);
+    }
+}
+}
+
+#endif
@@ -6,8 +6,24 @@
 
 #include "crypto/common.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstring>
 
+#if defined(ENABLE_AVX2) || defined(ENABLE_AVX512)
+#include "compat/cpuid.h"
+#endif
+
+namespace sha512_avx2
+{
+void Transform_4way(uint64_t* s, const unsigned char* chunk);
+}
+
+namespace sha512_avx512
+{
+void Transform_8way(uint64_t* s, const unsigned char* chunk);
+}
+
 // Internal implementation code.
 namespace
 {
@@ -146,8 +162,111 @@ void Transform(uint64_t* s, const unsigned char* chunk)
 
 } // namespace sha512
 
+typedef void (*TransformManyType)(uint64_t*, const unsigned char*);
+
+TransformManyType TransformMany_4way = nullptr;
+TransformManyType TransformMany_8way = nullptr;
+
+bool SelfTest()
+{
+    // Hash 15 lanes so that every available width plus the scalar tail is
+    // exercised, and compare against the scalar transform.
+    const size_t n = 15;
+    uint64_t states[8 * n], expected[8 * n];
+    unsigned char blocks[128 * n];
+    for (size_t i = 0; i < sizeof(blocks); ++i) {
+        blocks[i] = (unsigned char)(i * 37 + 11);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        sha512::Initialize(states + 8 * i);
+        states[8 * i] += i;
+        std::copy(states + 8 * i, states + 8 * i + 8, expected + 8 * i);
+        sha512::Transform(expected + 8 * i, blocks + 128 * i);
+    }
+    SHA512TransformMany(states, blocks, n);
+    return std::equal(states, states + 8 * n, expected);
+}
+
+#if defined(ENABLE_AVX2) || defined(ENABLE_AVX512)
+#if defined(HAVE_GETCPUID)
+/** Return the OS-enabled register state components (XCR0). */
+uint32_t XCR0()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return a;
+}
+#endif
+#endif
+
+// The scalar transform is used until detection has run, so hashing during
+// static initialization elsewhere is still correct.
+[[maybe_unused]] const std::string g_sha512_implementation = SHA512AutoDetect();
 } // namespace
 
+std::string SHA512AutoDetect()
+{
+    std::string ret = "standard";
+    TransformMany_4way = nullptr;
+    TransformMany_8way = nullptr;
+
+#if defined(ENABLE_AVX2) || defined(ENABLE_AVX512)
+#if defined(HAVE_GETCPUID)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    const uint32_t xcr0 = have_xsave && have_avx ? XCR0() : 0;
+    GetCPUID(0, 0, eax, ebx, ecx, edx);
+    if (eax >= 7) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+#if defined(ENABLE_AVX2)
+        // YMM state enabled by the OS.
+        if (((ebx >> 5) & 1) && (xcr0 & 0x06) == 0x06) {
+            TransformMany_4way = sha512_avx2::Transform_4way;
+            ret = "avx2(4way)";
+        }
+#endif
+#if defined(ENABLE_AVX512)
+        // ZMM and opmask state enabled by the OS.
+        if (((ebx >> 16) & 1) && (xcr0 & 0xe6) == 0xe6) {
+            TransformMany_8way = sha512_avx512::Transform_8way;
+            ret = TransformMany_4way ? ret + ",avx512(8way)" : "avx512(8way)";
+        }
+#endif
+    }
+#endif // defined(HAVE_GETCPUID)
+#endif
+
+    assert(SelfTest());
+    return ret;
+}
+
+void SHA512TransformMany(uint64_t* states, const unsigned char* blocks, size_t n)
+{
+    if (TransformMany_8way) {
+        while (n >= 8) {
+            TransformMany_8way(states, blocks);
+            states += 64;
+            blocks += 1024;
+            n -= 8;
+        }
+    }
+    if (TransformMany_4way) {
+        while (n >= 4) {
+            TransformMany_4way(states, blocks);
+            states += 32;
+            blocks += 512;
+            n -= 4;
+        }
+    }
+    while (n > 0) {
+        sha512::Transform(states, blocks);
+        states += 8;
+        blocks += 128;
+        --n;
+    }
+}
 
 ////// SHA-512
 
@@ -199,6 +318,12 @@ void CSHA512::Finalize(unsigned char hash[OUTPUT_SIZE])
     WriteBE64(hash + 56, s[7]);
 }
 
+void CSHA512::Midstate(uint64_t midstate[8]) const
+{
+    assert(bytes % 128 == 0);
+    std::copy(s, s + 8, midstate);
+}
+
 CSHA512& CSHA512::Reset()
 {
     bytes = 0;
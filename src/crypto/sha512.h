@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <string>
 
 /** A hasher class for SHA-512. */
 class CSHA512
@@ -24,6 +25,20 @@ public:
     void Finalize(unsigned char hash[OUTPUT_SIZE]);
     CSHA512& Reset();
     uint64_t Size() const { return bytes; }
+    /** Copy out the chaining state. Only meaningful after a multiple of 128
+     *  bytes has been written, when no data is left buffered. */
+    void Midstate(uint64_t midstate[8]) const;
 };
 
+/** Autodetect the best available multi-buffer SHA512 transform.
+ *  Returns the name of the implementation. Runs automatically on startup.
+ */
+std::string SHA512AutoDetect();
+
+/** Apply the SHA-512 compression function to n independent states at once.
+ *  states: pointer to n consecutive 8-word chaining states, updated in place
+ *  blocks: pointer to n consecutive 128-byte blocks, block i for state i
+ */
+void SHA512TransformMany(uint64_t* states, const unsigned char* blocks, size_t n);
+
 #endif // CRYPTO_SHA512_H
\ No newline at end of file
@@ -0,0 +1,122 @@
+// Copyright (c) 2017-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+namespace sha512_avx512 {
+namespace {
+
+const uint64_t K512[80] = {
+    0x428a2f98d728ae22ull, 0x7137449123ef65cdull, 0xb5c0fbcfec4d3b2full, 0xe9b5dba58189dbbcull,
+    0x3956c25bf348b538ull, 0x59f111f1b605d019ull, 0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull,
+    0xd807aa98a3030242ull, 0x12835b0145706fbeull, 0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+    0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull, 0x9bdc06a725c71235ull, 0xc19bf174cf692694ull,
+    0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull, 0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull,
+    0x2de92c6f592b0275ull, 0x4a7484aa6ea6e483ull, 0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+    0x983e5152ee66dfabull, 0xa831c66d2db43210ull, 0xb00327c898fb213full, 0xbf597fc7beef0ee4ull,
+    0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull, 0x06ca6351e003826full, 0x142929670a0e6e70ull,
+    0x27b70a8546d22ffcull, 0x2e1b21385c26c926ull, 0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+    0x650a73548baf63deull, 0x766a0abb3c77b2a8ull, 0x81c2c92e47edaee6ull, 0x92722c851482353bull,
+    0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull, 0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull,
+    0xd192e819d6ef5218ull, 0xd69906245565a910ull, 0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+    0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull, 0x2748774cdf8eeb99ull, 0x34b0bcb5e19b48a8ull,
+    0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull, 0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull,
+    0x748f82ee5defb2fcull, 0x78a5636f43172f60ull, 0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+    0x90befffa23631e28ull, 0xa4506cebde82bde9ull, 0xbef9a3f7b2c67915ull, 0xc67178f2e372532bull,
+    0xca273eceea26619cull, 0xd186b8c721c0c207ull, 0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull,
+    0x06f067aa72176fbaull, 0x0a637dc5a2c898a6ull, 0x113f9804bef90daeull, 0x1b710b35131c471bull,
+    0x28db77f523047d84ull, 0x32caab7b40c72493ull, 0x3c9ebe0a15c9bebcull, 0x431d67c49c100d4cull,
+    0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull, 0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull,
+};
+
+__m512i inline K(uint64_t x) { return _mm512_set1_epi64(x); }
+
+__m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi64(x, y); }
+__m512i inline Add(__m512i x, __m512i y, __m512i z) { return Add(Add(x, y), z); }
+__m512i inline Add(__m512i x, __m512i y, __m512i z, __m512i w) { return Add(Add(x, y), Add(z, w)); }
+__m512i inline Add(__m512i x, __m512i y, __m512i z, __m512i w, __m512i v) { return Add(Add(x, y, z), Add(w, v)); }
+/** Three-input xor in a single ternary-logic instruction. */
+__m512i inline Xor(__m512i x, __m512i y, __m512i z) { return _mm512_ternarylogic_epi64(x, y, z, 0x96); }
+/** Shift and rotate counts must be immediates, hence the template parameter. */
+template <int n> __m512i inline ShR(__m512i x) { return _mm512_srli_epi64(x, n); }
+template <int n> __m512i inline RotR(__m512i x) { return _mm512_ror_epi64(x, n); }
+
+__m512i inline Ch(__m512i x, __m512i y, __m512i z) { return _mm512_ternarylogic_epi64(x, y, z, 0xca); }
+__m512i inline Maj(__m512i x, __m512i y, __m512i z) { return _mm512_ternarylogic_epi64(x, y, z, 0xe8); }
+__m512i inline Sigma0(__m512i x) { return Xor(RotR<28>(x), RotR<34>(x), RotR<39>(x)); }
+__m512i inline Sigma1(__m512i x) { return Xor(RotR<14>(x), RotR<18>(x), RotR<41>(x)); }
+__m512i inline sigma0(__m512i x) { return Xor(RotR<1>(x), RotR<8>(x), ShR<7>(x)); }
+__m512i inline sigma1(__m512i x) { return Xor(RotR<19>(x), RotR<61>(x), ShR<6>(x)); }
+
+/** Word i of each lane's 128-byte block, in big-endian order. */
+__m512i inline Read(const unsigned char* chunk, int i)
+{
+    return _mm512_set_epi64(ReadBE64(chunk + 896 + 8 * i), ReadBE64(chunk + 768 + 8 * i),
+                            ReadBE64(chunk + 640 + 8 * i), ReadBE64(chunk + 512 + 8 * i),
+                            ReadBE64(chunk + 384 + 8 * i), ReadBE64(chunk + 256 + 8 * i),
+                            ReadBE64(chunk + 128 + 8 * i), ReadBE64(chunk + 8 * i));
+}
+
+/** Offsets of the lanes' states, in words. */
+__m512i inline Lanes() { return _mm512_set_epi64(56, 48, 40, 32, 24, 16, 8, 0); }
+
+/** State word i of each lane; lane j's state is s[8 * j] .. s[8 * j + 7]. */
+__m512i inline Load(const uint64_t* s, int i)
+{
+    return _mm512_i64gather_epi64(Lanes(), (const long long*)(s + i), 8);
+}
+
+void inline Store(uint64_t* s, int i, __m512i x)
+{
+    _mm512_i64scatter_epi64((long long*)(s + i), Lanes(), x, 8);
+}
+
+} // namespace
+
+/** Perform one SHA-512 transformation on each of 8 independent states.
+ *  s:     8 consecutive 8-word states.
+ *  chunk: 8 consecutive 128-byte blocks, block j for state j.
+ */
+void Transform_8way(uint64_t* s, const unsigned char* chunk)
+{
+    __m512i a = Load(s, 0), b = Load(s, 1), c = Load(s, 2), d = Load(s, 3);
+    __m512i e = Load(s, 4), f = Load(s, 5), g = Load(s, 6), h = Load(s, 7);
+    __m512i w[16];
+
+    for (int i = 0; i < 80; ++i) {
+        if (i < 16) {
+            w[i] = Read(chunk, i);
+        } else {
+            w[i & 15] = Add(sigma1(w[(i - 2) & 15]), w[(i - 7) & 15], sigma0(w[(i - 15) & 15]), w[i & 15]);
+        }
+        __m512i t1 = Add(h, Sigma1(e), Ch(e, f, g), K(K512[i]), w[i & 15]);
+        __m512i t2 = Add(Sigma0(a), Maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = Add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = Add(t1, t2);
+    }
+
+    Store(s, 0, Add(a, Load(s, 0)));
+    Store(s, 1, Add(b, Load(s, 1)));
+    Store(s, 2, Add(c, Load(s, 2)));
+    Store(s, 3, Add(d, Load(s, 3)));
+    Store(s, 4, Add(e, Load(s, 4)));
+    Store(s, 5, Add(f, Load(s, 5)));
+    Store(s, 6, Add(g, Load(s, 6)));
+    Store(s, 7, Add(h, Load(s, 7)));
+}
+
+}
+
+#endif
@@ -1,10 +1,197 @@
 #include "curve.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "random.h"
 #include "secp256k1.h"
+#include "secp256k1_preallocated.h"
+#include "secp256k1_recovery.h"
+#include "support/cleanse.h"
+#include "wallet_core/init.h"
+
+namespace {
+// 每个线程的上下文使用这么多次后重新随机化
+constexpr uint32_t RERANDOMIZE_INTERVAL = 1024;
+// 每个上下文按缓存行对齐，避免不同线程的上下文共享缓存行
+constexpr size_t SLOT_ALIGNMENT = 64;
+
+void randomize(secp256k1_context* ctx) {
+    unsigned char seed[32];
+    wallet::GetOSRand(seed);
+    const int ok = secp256k1_context_randomize(ctx, seed);
+    memory_cleanse(seed, sizeof(seed));
+    if (!ok) {
+        throw std::runtime_error("Failed to randomize secp256k1 context");
+    }
+}
+
+/// Contexts created in one aligned block of memory, handed out to threads.
+class ContextArena {
+public:
+    explicit ContextArena(size_t count)
+        : slot_size_((secp256k1_context_preallocated_size(SECP256K1_CONTEXT_NONE) + SLOT_ALIGNMENT - 1) /
+                     SLOT_ALIGNMENT * SLOT_ALIGNMENT),
+          memory_(static_cast<unsigned char*>(
+              ::operator new(slot_size_ * count, std::align_val_t{SLOT_ALIGNMENT}))) {
+        contexts_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            contexts_.push_back(secp256k1_context_preallocated_create(memory_ + i * slot_size_,
+                                                                      SECP256K1_CONTEXT_NONE));
+        }
+        // 逆序放入，先分配低地址的槽位
+        free_.reserve(count);
+        for (size_t i = count; i > 0; --i) {
+            free_.push_back(i - 1);
+        }
+    }
+
+    ~ContextArena() {
+        for (auto* ctx : contexts_) {
+            secp256k1_context_preallocated_destroy(ctx);
+        }
+        memory_cleanse(memory_, slot_size_ * contexts_.size());
+        ::operator delete(memory_, std::align_val_t{SLOT_ALIGNMENT});
+    }
+
+    ContextArena(const ContextArena&) = delete;
+    ContextArena& operator=(const ContextArena&) = delete;
+
+    /// Returns the index of a free context, or `SIZE_MAX` if none is left.
+    size_t acquire() {
+        if (free_.empty()) {
+            return SIZE_MAX;
+        }
+        const size_t slot = free_.back();
+        free_.pop_back();
+        return slot;
+    }
+
+    void release(size_t slot) { free_.push_back(slot); }
+
+    secp256k1_context* context(size_t slot) const { return contexts_[slot]; }
+
+private:
+    const size_t slot_size_;
+    unsigned char* const memory_;
+    std::vector<secp256k1_context*> contexts_;
+    std::vector<size_t> free_;
+};
+
+std::mutex g_mutex;
+// 受 g_mutex 保护
+ContextArena* g_arena = nullptr;
+// 每次 shutdown 递增，线程据此发现自己持有的上下文已被销毁
+std::atomic<uint64_t> g_generation{0};
+
+size_t default_context_count() {
+    // 调用线程、DerivationEngine 和 JNI 的工作线程都可能同时使用上下文
+    return std::max<size_t>(16, 4 * std::thread::hardware_concurrency());
+}
+
+/// The context a thread has borrowed, returned when the thread exits.
+struct Lease {
+    secp256k1_context* ctx = nullptr;
+    // SIZE_MAX 表示竞技场已满时单独创建的上下文
+    size_t slot = SIZE_MAX;
+    uint64_t generation = 0;
+    uint32_t uses = 0;
+
+    ~Lease() { release(); }
+
+    void acquire() {
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            if (!g_arena) {
+                g_arena = new ContextArena(default_context_count());
+            }
+            slot = g_arena->acquire();
+            ctx = slot != SIZE_MAX ? g_arena->context(slot)
+                                   : secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+            generation = g_generation.load(std::memory_order_relaxed);
+        }
+        uses = 0;
+        try {
+            randomize(ctx);
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    void release() {
+        if (!ctx) {
+            return;
+        }
+        if (slot == SIZE_MAX) {
+            secp256k1_context_destroy(ctx);
+        } else {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            // shutdown 之后旧竞技场已经释放，不能归还
+            if (g_arena && generation == g_generation.load(std::memory_order_relaxed)) {
+                g_arena->release(slot);
+            }
+        }
+        ctx = nullptr;
+        slot = SIZE_MAX;
+    }
+};
+
+thread_local Lease t_lease;
+}  // namespace
 
 secp256k1_context *get_secp256k1_context() {
-    static secp256k1_context* ctx = []() -> secp256k1_context* {
-        auto* c = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
-        return c;
-    }();
-    return ctx;
-}
\ No newline at end of file
+    Lease& lease = t_lease;
+    if (!lease.ctx || lease.generation != g_generation.load(std::memory_order_acquire)) {
+        lease.release();
+        lease.acquire();
+    } else if (++lease.uses >= RERANDOMIZE_INTERVAL) {
+        lease.uses = 0;
+        randomize(lease.ctx);
+    }
+    return lease.ctx;
+}
+
+bool sign_recoverable(const secp256k1_context* ctx, const unsigned char* key32,
+                      const unsigned char* hash32, unsigned char* out65) {
+    secp256k1_ecdsa_recoverable_signature sig;
+    int recid;
+    if (!secp256k1_ecdsa_sign_recoverable(ctx, &sig, hash32, key32, nullptr, nullptr) ||
+        !secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, out65, &recid, &sig)) {
+        return false;
+    }
+    // Tron 与以太坊一样在 v 上加 27
+    out65[64] = static_cast<unsigned char>(recid + 27);
+    return true;
+}
+
+namespace wallet {
+
+void init(size_t contexts) {
+    // 提前确认系统随机数可用，而不是等到第一次使用密钥时才失败
+    unsigned char probe[32];
+    GetOSRand(probe);
+    memory_cleanse(probe, sizeof(probe));
+    auto* arena = new ContextArena(contexts ? contexts : default_context_count());
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_arena) {
+        delete arena;
+        return;
+    }
+    g_arena = arena;
+}
+
+void shutdown() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    delete g_arena;
+    g_arena = nullptr;
+    g_generation.fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace wallet
@@ -5,4 +5,9 @@ struct secp256k1_context_struct;
 
 secp256k1_context_struct* get_secp256k1_context();
 
+/** Signs `hash32` with `key32` and writes r || s || (recid + 27) to `out65`.
+ *  Returns false if the key is invalid. */
+bool sign_recoverable(const secp256k1_context_struct* ctx, const unsigned char* key32,
+                      const unsigned char* hash32, unsigned char* out65);
+
 #endif // WALLET_CURVE_H
\ No newline at end of file
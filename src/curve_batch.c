@@ -0,0 +1,148 @@
+/* Batched point arithmetic built directly on the libsecp256k1 internals.
+ *
+ * The public libsecp256k1 API converts every result back to affine
+ * coordinates, paying one field inversion per point. The routines here keep
+ * intermediate points in Jacobian form and normalize whole batches at once.
+ * This file must be compiled with the same configuration macros as the
+ * vendored library (see CMakeLists.txt) so that table layouts match. */
+
+#include "curve_batch.h"
+
+#include "assumptions.h"
+#include "util.h"
+
+#include "field_impl.h"
+#include "scalar_impl.h"
+#include "group_impl.h"
+#include "ecmult_gen_impl.h"
+#include "scratch_impl.h"
+#include "ecmult_impl.h"
+#include "ecdsa_impl.h"
+#include "int128_impl.h"
+
+/* The vendored libsecp256k1 keeps the generator multiplication context as the
+ * first member of secp256k1_context_struct (see secp256k1.c), so a context
+ * pointer is also a pointer to its ecmult_gen context. Using it means batched
+ * operations share the context's blinding. */
+static const secp256k1_ecmult_gen_context *curve_gen_context(const secp256k1_context *ctx) {
+    return (const secp256k1_ecmult_gen_context *)(const void *)ctx;
+}
+
+int curve_pubkey_tweak_add_batch(const secp256k1_context *ctx, secp256k1_pubkey *out,
+                                 const secp256k1_pubkey *base, const unsigned char *tweaks32,
+                                 size_t n) {
+    const secp256k1_ecmult_gen_context *gen_ctx = curve_gen_context(ctx);
+    secp256k1_gej sums[CURVE_BATCH_SIZE];
+    secp256k1_ge affine[CURVE_BATCH_SIZE];
+    secp256k1_ge base_ge;
+    secp256k1_scalar tweak;
+    size_t done, i, chunk;
+    int overflow;
+
+    if (!secp256k1_ecmult_gen_context_is_built(gen_ctx)) {
+        return 0;
+    }
+    secp256k1_ge_from_bytes(&base_ge, base->data);
+    if (secp256k1_fe_is_zero(&base_ge.x)) {
+        return 0;
+    }
+
+    for (done = 0; done < n; done += chunk) {
+        chunk = n - done < CURVE_BATCH_SIZE ? n - done : CURVE_BATCH_SIZE;
+        for (i = 0; i < chunk; i++) {
+            secp256k1_scalar_set_b32(&tweak, tweaks32 + 32 * (done + i), &overflow);
+            if (overflow) {
+                return 0;
+            }
+            secp256k1_ecmult_gen(gen_ctx, &sums[i], &tweak);
+            secp256k1_gej_add_ge_var(&sums[i], &sums[i], &base_ge, NULL);
+            if (secp256k1_gej_is_infinity(&sums[i])) {
+                return 0;
+            }
+        }
+        secp256k1_ge_set_all_gej_var(affine, sums, chunk);
+        for (i = 0; i < chunk; i++) {
+            secp256k1_ge_to_bytes(out[done + i].data, &affine[i]);
+        }
+    }
+    secp256k1_scalar_clear(&tweak);
+    return 1;
+}
+
+/* Same as secp256k1_ecdsa_sig_recover in the recovery module, except that the
+ * key is left in Jacobian form for the caller to normalize. */
+static int curve_ecdsa_sig_recover(secp256k1_gej *pubkey, const unsigned char *sig65,
+                                   const unsigned char *hash32) {
+    secp256k1_scalar r, s, m, rn, u1, u2;
+    secp256k1_fe fx;
+    secp256k1_ge x;
+    secp256k1_gej xj;
+    int overflow, recid;
+
+    recid = sig65[64] >= 27 ? sig65[64] - 27 : sig65[64];
+    if (recid > 3) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(&r, sig65, &overflow);
+    if (overflow || secp256k1_scalar_is_zero(&r)) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(&s, sig65 + 32, &overflow);
+    if (overflow || secp256k1_scalar_is_zero(&s)) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(&m, hash32, NULL);
+
+    /* r is below the order, so it is also below p */
+    secp256k1_fe_set_b32_limit(&fx, sig65);
+    if (recid & 2) {
+        if (secp256k1_fe_cmp_var(&fx, &secp256k1_ecdsa_const_p_minus_order) >= 0) {
+            return 0;
+        }
+        secp256k1_fe_add(&fx, &secp256k1_ecdsa_const_order_as_fe);
+    }
+    if (!secp256k1_ge_set_xo_var(&x, &fx, recid & 1)) {
+        return 0;
+    }
+    secp256k1_gej_set_ge(&xj, &x);
+    secp256k1_scalar_inverse_var(&rn, &r);
+    secp256k1_scalar_mul(&u1, &rn, &m);
+    secp256k1_scalar_negate(&u1, &u1);
+    secp256k1_scalar_mul(&u2, &rn, &s);
+    secp256k1_ecmult(pubkey, &xj, &u2, &u1);
+    return !secp256k1_gej_is_infinity(pubkey);
+}
+
+size_t curve_ecdsa_recover_batch(unsigned char *xy64, unsigned char *valid,
+                                 const unsigned char *sigs65, const unsigned char *hashes32,
+                                 size_t n) {
+    secp256k1_gej keys[CURVE_BATCH_SIZE];
+    secp256k1_ge affine[CURVE_BATCH_SIZE];
+    size_t done, i, chunk, count = 0;
+
+    for (done = 0; done < n; done += chunk) {
+        chunk = n - done < CURVE_BATCH_SIZE ? n - done : CURVE_BATCH_SIZE;
+        for (i = 0; i < chunk; i++) {
+            valid[done + i] = (unsigned char)curve_ecdsa_sig_recover(
+                &keys[i], sigs65 + 65 * (done + i), hashes32 + 32 * (done + i));
+            if (!valid[done + i]) {
+                /* ge_set_all_gej_var skips points at infinity */
+                secp256k1_gej_set_infinity(&keys[i]);
+            }
+        }
+        secp256k1_ge_set_all_gej_var(affine, keys, chunk);
+        for (i = 0; i < chunk; i++) {
+            unsigned char *out = xy64 + 64 * (done + i);
+            if (valid[done + i]) {
+                secp256k1_fe_normalize_var(&affine[i].x);
+                secp256k1_fe_normalize_var(&affine[i].y);
+                secp256k1_fe_get_b32(out, &affine[i].x);
+                secp256k1_fe_get_b32(out + 32, &affine[i].y);
+                count++;
+            } else {
+                memset(out, 0, 64);
+            }
+        }
+    }
+    return count;
+}
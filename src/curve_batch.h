@@ -0,0 +1,49 @@
+#ifndef WALLET_CURVE_BATCH_H
+#define WALLET_CURVE_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "secp256k1.h"
+
+/* Number of points normalized together by one field inversion. Larger
+ * batches are processed in chunks of this size. */
+#define CURVE_BATCH_SIZE 64
+
+/* Computes out[i] = base + t[i]*G for the n 32-byte big-endian tweaks t,
+ * the public half of BIP32 child derivation for a run of siblings.
+ *
+ * The sums stay in Jacobian coordinates and are brought back to affine form
+ * together with a single Montgomery batch inversion per CURVE_BATCH_SIZE
+ * points, instead of one inversion per point.
+ *
+ * Returns 1 on success. Returns 0 if ctx cannot multiply the generator, a
+ * tweak is not below the group order or a sum is the point at infinity; out
+ * is unspecified in that case. */
+int curve_pubkey_tweak_add_batch(const secp256k1_context *ctx, secp256k1_pubkey *out,
+                                 const secp256k1_pubkey *base, const unsigned char *tweaks32,
+                                 size_t n);
+
+/* Recovers the public keys of n recoverable ECDSA signatures, like
+ * secp256k1_ecdsa_recover, and writes each as its 64-byte x || y coordinates
+ * (the uncompressed encoding without the 0x04 prefix) to xy64.
+ *
+ * sigs65 holds n signatures as r || s || v, where v is the recovery id either
+ * as is (0-3) or plus 27; hashes32 holds the n signed digests. The recovered
+ * points are normalized together, one field inversion per CURVE_BATCH_SIZE
+ * signatures.
+ *
+ * Sets valid[i] to whether signature i recovers to a key; the coordinates of
+ * an invalid one are zero. Returns the number of valid signatures. */
+size_t curve_ecdsa_recover_batch(unsigned char *xy64, unsigned char *valid,
+                                 const unsigned char *sigs65, const unsigned char *hashes32,
+                                 size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WALLET_CURVE_BATCH_H */
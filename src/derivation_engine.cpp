@@ -0,0 +1,118 @@
+#include "wallet_core/derivation_engine.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "bip32.h"
+#include "curve.h"
+#include "curve_batch.h"
+#include "thread_pool.h"
+#include "wallet_core/derivation_path.h"
+#include "wallet_core/extended_key.h"
+
+using namespace wallet;
+
+namespace {
+// 每个任务处理的地址数量，足够摊薄任务调度开销
+const size_t RANGE_GRAIN = 256;
+// 每个任务处理的种子数量，每个种子都要从主节点完整派生
+constexpr size_t SEED_GRAIN = 16;
+
+HDNode derive_from_seed(const HDWallet::SeedData& seed, const DerivationPath& path) {
+    auto node = HDNode::fromSeed(seed);
+    for (auto& index : path.indices) {
+        node = node.privateCkd(index.derivationIndex());
+    }
+    return node;
+}
+
+void check_range(uint32_t change, uint32_t start, size_t count) {
+    if (change & 0x80000000 || count > 0x80000000 - uint64_t{start}) {
+        throw std::invalid_argument("Range exceeds the non-hardened index space");
+    }
+}
+
+template <typename T>
+void check_output_size(std::span<const HDWallet::SeedData> seeds, std::span<T> out) {
+    if (seeds.size() != out.size()) {
+        throw std::invalid_argument("Output size does not match the number of seeds");
+    }
+}
+}  // namespace
+
+DerivationEngine::DerivationEngine(size_t threads)
+    : pool_(std::make_unique<ThreadPool>(threads)) {}
+
+DerivationEngine::~DerivationEngine() = default;
+
+size_t DerivationEngine::threads() const { return pool_->size(); }
+
+void DerivationEngine::deriveRange(const std::string& extended, uint32_t change,
+                                   uint32_t start, std::span<PublicKey::KeyData> out) {
+    const auto parent = deriveRangeParent(extended, change, start, out.size());
+    pool_->parallelFor(out.size(), RANGE_GRAIN, [&](size_t begin, size_t end) {
+        parent.publicCkdBatch(start + static_cast<uint32_t>(begin), out.subspan(begin, end - begin));
+    });
+}
+
+void DerivationEngine::deriveTronAddressRange(const std::string& extended, uint32_t change,
+                                              uint32_t start,
+                                              std::span<tron::TronAddress::Data> out) {
+    const auto parent = deriveRangeParent(extended, change, start, out.size());
+    pool_->parallelFor(out.size(), RANGE_GRAIN, [&](size_t begin, size_t end) {
+        std::array<secp256k1_pubkey, CURVE_BATCH_SIZE> points;
+        for (size_t done = begin; done < end; done += points.size()) {
+            auto batch = std::span(points).first(std::min(points.size(), end - done));
+            parent.publicCkdBatch(start + static_cast<uint32_t>(done), batch);
+            tron::TronAddress::derive_from_points(batch, out.subspan(done, batch.size()));
+        }
+    });
+}
+
+void DerivationEngine::deriveRange(const ExtendedKey& key, uint32_t change, uint32_t start,
+                                   std::span<PublicKey::KeyData> out) {
+    check_range(change, start, out.size());
+    pool_->parallelFor(out.size(), RANGE_GRAIN, [&](size_t begin, size_t end) {
+        key.deriveRange(change, start + static_cast<uint32_t>(begin),
+                        out.subspan(begin, end - begin));
+    });
+}
+
+void DerivationEngine::deriveTronAddressRange(const ExtendedKey& key, uint32_t change,
+                                              uint32_t start,
+                                              std::span<tron::TronAddress::Data> out) {
+    check_range(change, start, out.size());
+    pool_->parallelFor(out.size(), RANGE_GRAIN, [&](size_t begin, size_t end) {
+        key.deriveTronAddressRange(change, start + static_cast<uint32_t>(begin),
+                                   out.subspan(begin, end - begin));
+    });
+}
+
+void DerivationEngine::deriveKeys(std::span<const HDWallet::SeedData> seeds,
+                                  const DerivationPath& path,
+                                  std::span<PrivateKey::KeyData> out) {
+    check_output_size(seeds, out);
+    pool_->parallelFor(seeds.size(), SEED_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            out[i] = derive_from_seed(seeds[i], path).privateKey();
+        }
+    });
+}
+
+void DerivationEngine::deriveTronAddresses(std::span<const HDWallet::SeedData> seeds,
+                                           const DerivationPath& path,
+                                           std::span<tron::TronAddress::Data> out) {
+    check_output_size(seeds, out);
+    pool_->parallelFor(seeds.size(), SEED_GRAIN, [&](size_t begin, size_t end) {
+        std::array<secp256k1_pubkey, SEED_GRAIN> points;
+        auto ctx = get_secp256k1_context();
+        for (size_t i = begin; i < end; ++i) {
+            const auto node = derive_from_seed(seeds[i], path);
+            if (!secp256k1_ec_pubkey_create(ctx, &points[i - begin], node.private_key_data)) {
+                throw std::runtime_error("Failed to create public key");
+            }
+        }
+        tron::TronAddress::derive_from_points(std::span(points).first(end - begin),
+                                              out.subspan(begin, end - begin));
+    });
+}
@@ -4,50 +4,72 @@
 
 using namespace wallet;
 
-DerivationPath::DerivationPath(const std::string& string) {
-    const auto* it = string.data();
-    const auto* end = string.data() + string.size();
-
-    if (it != end && *it == 'm') {
-        ++it;
-    }
-    if (it != end && *it == '/') {
-        ++it;
+namespace {
+const char* error_message(DerivationPathError error) {
+    switch (error) {
+    case DerivationPathError::None:
+        return "";
+    case DerivationPathError::InvalidComponent:
+        return "Invalid component";
+    case DerivationPathError::MissingSeparator:
+        return "Components should be separated by '/'";
+    case DerivationPathError::IndexOutOfRange:
+        return "Component is out of range";
     }
+    return "Invalid derivation path";
+}
+}  // namespace
 
-    while (it != end) {
-        uint32_t value;
-        if (std::sscanf(it, "%ud", &value) != 1) {
-            throw std::invalid_argument("Invalid component");
-        }
-        while (it != end && isdigit(*it)) {
-            ++it;
-        }
+DerivationPath::DerivationPath(std::string_view string) {
+    const auto error = parse(string, *this);
+    if (error != DerivationPathError::None) {
+        throw std::invalid_argument(error_message(error));
+    }
+}
 
-        auto hardened = (it != end && *it == '\'');
-        if (hardened) {
-            ++it;
-        }
-        indices.emplace_back(value, hardened);
+DerivationPathError DerivationPath::parse(std::string_view string, DerivationPath& path) noexcept {
+    Indices indices;
+    const auto error = detail::parseDerivationPath(string, [&](DerivationPathIndex index) {
+        indices.push_back(index);
+    });
+    if (error == DerivationPathError::None) {
+        path.indices = std::move(indices);
+    }
+    return error;
+}
 
-        if (it == end) {
-            break;
+size_t DerivationPath::format(std::span<char> out) const noexcept {
+    if (out.size() < maxStringSize(indices.size())) {
+        return 0;
+    }
+    char* p = out.data();
+    *p++ = 'm';
+    for (auto& index : indices) {
+        *p++ = '/';
+        // 先逆序写出各位数字
+        char digits[10];
+        size_t n = 0;
+        uint32_t value = index.value;
+        do {
+            digits[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        while (n != 0) {
+            *p++ = digits[--n];
         }
-        if (*it != '/') {
-            throw std::invalid_argument("Components should be separated by '/'");
+        if (index.hardened) {
+            *p++ = '\'';
         }
-        ++it;
     }
+    return static_cast<size_t>(p - out.data());
 }
 
 std::string DerivationPath::string() const noexcept {
-    std::string result = "m/";
-    for (auto& index : indices) {
-        result += index.string();
-        result += "/";
-    }
-    if (result.back() == '/') {
-        result.erase(result.end() - 1);
+    char buffer[maxStringSize(INLINE_DEPTH)];
+    if (indices.size() <= INLINE_DEPTH) {
+        return std::string(buffer, format(buffer));
     }
+    std::string result(maxStringSize(indices.size()), '\0');
+    result.resize(format(result));
     return result;
 }
@@ -0,0 +1,143 @@
+#include "wallet_core/extended_key.h"
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+#include "bip32.h"
+#include "curve_batch.h"
+#include "support/cleanse.h"
+#include "wallet_core/derivation_path.h"
+
+using namespace wallet;
+
+struct ExtendedKey::Impl {
+    /// Number of change-level nodes kept, i.e. the receive and change chains.
+    static constexpr uint32_t CACHED_CHANGES = 2;
+
+    CkdContext account;
+    uint32_t parent_fingerprint;
+    bool is_private;
+    mutable std::once_flag change_once[CACHED_CHANGES];
+    mutable std::optional<CkdContext> change[CACHED_CHANGES];
+
+    Impl(const HDNode& node, uint32_t parent_fingerprint, bool is_private)
+        : account(node), parent_fingerprint(parent_fingerprint), is_private(is_private) {}
+
+    ~Impl() {
+        memory_cleanse(&account, sizeof(account));
+        for (auto& ckd : change) {
+            if (ckd) {
+                memory_cleanse(&*ckd, sizeof(*ckd));
+            }
+        }
+    }
+
+    HDNode child(const CkdContext& parent, uint32_t index) const {
+        return is_private ? parent.privateCkd(index) : parent.publicCkd(index);
+    }
+
+    /// Context of the `index` child, with its public key filled in. Returns
+    /// the kept one for the usual chains, otherwise derives into `scratch`.
+    const CkdContext& changeContext(uint32_t index, std::optional<CkdContext>& scratch) const {
+        auto derive = [&](std::optional<CkdContext>& out) {
+            HDNode node = child(account, index);
+            // 私钥派生的子节点没有公钥，后续派生地址时需要
+            node.fillPublicKey();
+            out.emplace(node);
+        };
+        if (index < CACHED_CHANGES) {
+            std::call_once(change_once[index], derive, change[index]);
+            return *change[index];
+        }
+        derive(scratch);
+        return *scratch;
+    }
+};
+
+ExtendedKey::ExtendedKey(std::shared_ptr<const Impl> impl) : impl_(std::move(impl)) {}
+
+ExtendedKey ExtendedKey::parse(const std::string& extended) {
+    uint32_t parent_fingerprint;
+    bool is_private;
+    HDNode node = HDNode::deserialize(extended, &parent_fingerprint, &is_private);
+    // 非强化派生需要父节点公钥，解码时一次性算好
+    node.fillPublicKey();
+    auto impl = std::make_shared<const Impl>(node, parent_fingerprint, is_private);
+    memory_cleanse(&node, sizeof(node));
+    return ExtendedKey(std::move(impl));
+}
+
+bool ExtendedKey::isPrivate() const {
+    return impl_->is_private;
+}
+
+std::string ExtendedKey::serialize() const {
+    return impl_->account.node().serialize(impl_->parent_fingerprint, !impl_->is_private);
+}
+
+std::string ExtendedKey::serializePublic() const {
+    return impl_->account.node().serialize(impl_->parent_fingerprint, true);
+}
+
+ExtendedKey ExtendedKey::derive(uint32_t index) const {
+    HDNode parent = impl_->account.node();
+    HDNode node = impl_->child(impl_->account, index);
+    node.fillPublicKey();
+    auto impl = std::make_shared<const Impl>(node, parent.fingerprint(), impl_->is_private);
+    memory_cleanse(&parent, sizeof(parent));
+    memory_cleanse(&node, sizeof(node));
+    return ExtendedKey(std::move(impl));
+}
+
+PublicKey ExtendedKey::derivePublicKey(const DerivationPath& path) const {
+    std::optional<CkdContext> scratch;
+    // 只需要公钥，私钥同样走公钥派生
+    HDNode node = impl_->changeContext(path.change(), scratch).publicCkd(path.address());
+    node.fillPublicKey();
+    return PublicKey{node.publicKey()};
+}
+
+PrivateKey ExtendedKey::derivePrivateKey(const DerivationPath& path) const {
+    if (!impl_->is_private) {
+        throw std::runtime_error("Not an extended private key");
+    }
+    std::optional<CkdContext> scratch;
+    HDNode node = impl_->changeContext(path.change(), scratch).privateCkd(path.address());
+    PrivateKey key{node.privateKey()};
+    memory_cleanse(&node, sizeof(node));
+    return key;
+}
+
+tron::TronAddress ExtendedKey::deriveTronAddress(const DerivationPath& path) const {
+    std::optional<CkdContext> scratch;
+    secp256k1_pubkey point;
+    impl_->changeContext(path.change(), scratch)
+        .publicCkdBatch(path.address(), std::span(&point, 1));
+    return tron::TronAddress::derive_from_point(point);
+}
+
+void ExtendedKey::deriveRange(uint32_t change, uint32_t start,
+                              std::span<PublicKey::KeyData> out) const {
+    if (change & 0x80000000 || out.size() > 0x80000000 - uint64_t{start}) {
+        throw std::invalid_argument("Range exceeds the non-hardened index space");
+    }
+    std::optional<CkdContext> scratch;
+    impl_->changeContext(change, scratch).publicCkdBatch(start, out);
+}
+
+void ExtendedKey::deriveTronAddressRange(uint32_t change, uint32_t start,
+                                         std::span<tron::TronAddress::Data> out) const {
+    if (change & 0x80000000 || out.size() > 0x80000000 - uint64_t{start}) {
+        throw std::invalid_argument("Range exceeds the non-hardened index space");
+    }
+    std::optional<CkdContext> scratch;
+    const CkdContext& parent = impl_->changeContext(change, scratch);
+    std::array<secp256k1_pubkey, CURVE_BATCH_SIZE> points;
+    for (size_t done = 0; done < out.size(); done += points.size()) {
+        auto batch = std::span(points).first(std::min(points.size(), out.size() - done));
+        parent.publicCkdBatch(start + static_cast<uint32_t>(done), batch);
+        tron::TronAddress::derive_from_points(batch, out.subspan(done, batch.size()));
+    }
+}
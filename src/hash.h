@@ -10,7 +10,7 @@
 #include "crypto/common.h"
 #include "crypto/ripemd160.h"
 #include "crypto/sha256.h"
-#include "prevector.h"
+#include "wallet_core/prevector.h"
 #include "serialize.h"
 #include "span.h"
 #include "uint256.h"
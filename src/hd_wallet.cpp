@@ -1,6 +1,8 @@
 ﻿#include "wallet_core/hd_wallet.h"
 
+#include <algorithm>
 #include <iostream>
+#include <span>
 #include <stdexcept>
 
 #include "crypto/common.h"
@@ -8,149 +10,104 @@
 #include "bip32.h"
 #include "hash.h"
 #include "wallet_core/derivation_path.h"
+#include "wallet_core/extended_key.h"
 #include "curve.h"
+#include "node_cache.h"
+#include "support/cleanse.h"
 
-namespace {
-using namespace wallet;
-static HDNode get_root_node(const HDWallet& wallet) {
-  return HDNode::fromSeed(wallet.getSeed());
-}
+namespace wallet {
+static const uint32_t PURPOSE_BIP44 = static_cast<uint32_t>(Purpose::BIP44);
 
-static HDNode get_node(const HDWallet& wallet, const DerivationPath& path) {
-  auto node = get_root_node(wallet);
-  for (auto& ind : path.indices) {
-    node = node.privateCkd(ind.derivationIndex());
-  }
-  return node;
+HDWallet::HDWallet(const std::vector<byte>& seed)
+    : cache_(std::make_unique<NodeCache>()) {
+  std::copy_n(seed.begin(), 64, this->seed_.begin());
 }
 
-static uint32_t node_fingerprint(HDNode& node) {
-  node.fillPublicKey();
-  std::array<byte, CHash160::OUTPUT_SIZE> digest;
-  CHash160().Write(node.public_key_data).Finalize(digest);
-  return ((uint32_t)digest[0] << 24) + (digest[1] << 16) + (digest[2] << 8) +
-         digest[3];
-}
+HDWallet::HDWallet(const SeedData& seed)
+    : seed_(seed), cache_(std::make_unique<NodeCache>()) {}
 
-static std::string node_serialize(const HDNode& node, uint32_t fingerprint,
-                                  bool use_public) {
-  std::array<byte, 78> buf;
-  uint32_t version;
-  byte* ptr = buf.data();
-  // 4字节版本号
-  if (use_public) {
-    {
-      WriteBE32(ptr, 0x0488B21E);
-      ptr += 4;
-    }
-  } else {
-    {
-      WriteBE32(ptr, 0x0488ADE4);
-      ptr += 4;
-    }
-  }
-  // 1字节的深度
-  {
-    *ptr++ = node.depth;
-  }
-  // 4字节的父节点指纹
-  {
-    WriteBE32(ptr, fingerprint);
-    ptr += 4;
-  }
-  // 4字节的子节点编号
-  {
-    WriteBE32(ptr, node.child_num);
-    ptr += 4;
-  }
-  // 32字节的链码
-  {
-    std::copy(node.chain_code.begin(), node.chain_code.end(), ptr);
-    ptr += 32;
+HDWallet::HDWallet(const HDWallet& other)
+    : seed_(other.seed_), cache_(std::make_unique<NodeCache>()) {}
+
+HDWallet::HDWallet(HDWallet&& other) noexcept
+    : seed_(other.seed_), cache_(std::move(other.cache_)) {}
+
+HDWallet& HDWallet::operator=(const HDWallet& other) {
+  if (this != &other) {
+    seed_ = other.seed_;
+    cache_ = std::make_unique<NodeCache>();
   }
-  if (use_public) {
-    // 填充33字节公钥
-    std::copy(std::begin(node.public_key_data), std::end(node.public_key_data),
-              ptr);
-  } else {
-    // 填充0x00 || ser256(k)
-    {
-      *ptr++ = 0;
-    }
-    std::copy(std::begin(node.private_key_data),
-              std::end(node.private_key_data), ptr);
+  return *this;
+}
+
+HDWallet& HDWallet::operator=(HDWallet&& other) noexcept {
+  if (this != &other) {
+    seed_ = other.seed_;
+    cache_ = std::move(other.cache_);
   }
-  return EncodeBase58Check(buf);
+  return *this;
 }
 
-static void node_deserialize(const std::string& extended, HDNode* node) {
-  std::vector<unsigned char> buf;
-  if (!DecodeBase58Check(extended, buf, 78)) {
-    throw std::runtime_error("");
+HDWallet::~HDWallet() { memory_cleanse(seed_.data(), seed_.size()); }
+
+const std::array<byte, 64>& HDWallet::getSeed() const { return this->seed_; }
+
+HDNode HDWallet::deriveNode(const DerivationPath& path) const {
+  std::span<const DerivationPathIndex> indices{path.indices};
+  std::optional<CkdContext> parent;
+  std::optional<size_t> cached;
+  if (cache_) {
+    // 只查找路径前缀，叶子节点（通常是地址）不进入缓存
+    auto prefix = indices.empty() ? indices : indices.first(indices.size() - 1);
+    cached = cache_->lookup(prefix, parent);
   }
-  const byte* ptr = buf.data();
-  bool is_public;
-  uint32_t version = ReadBE32(ptr);
-  ptr += 4;
-  if (version == 0x0488B21E) {
-    // 扩展公钥
-    is_public = true;
-  } else if (version == 0x0488ADE4) {
-    // 扩展私钥
-    is_public = false;
-  } else {
-    throw std::runtime_error("");
+  if (!cached) {
+    parent.emplace(HDNode::fromSeed(seed_));
   }
-  node->depth = *ptr++;
-  uint32_t _ = ReadBE32(ptr);
-  ptr += 4;
-  node->child_num = ReadBE32(ptr);
-  ptr += 4;
-  std::copy(ptr, ptr + 32, node->chain_code.begin());
-  ptr += 32;
-  if (is_public) {
-    std::copy(ptr, ptr + 33, node->public_key_data);
-  } else {
-    if (*ptr++ != 0x00) {
-      throw std::runtime_error("");
+  bool fresh = !cached;
+  for (size_t depth = cached.value_or(0); depth < indices.size(); ++depth) {
+    auto child = parent->privateCkd(indices[depth].derivationIndex());
+    // 父节点在派生子节点之后才缓存，以保留派生过程中计算的公钥
+    if (fresh && cache_) {
+      cache_->insert(indices.first(depth), *parent);
     }
-    std::copy(ptr, ptr + 32, node->private_key_data);
+    if (depth + 1 == indices.size()) {
+      return child;
+    }
+    parent.emplace(child);
+    fresh = true;
   }
-}
-}  // namespace
-
-namespace wallet {
-static const uint32_t PURPOSE_BIP44 = static_cast<uint32_t>(Purpose::BIP44);
-
-HDWallet::HDWallet(const std::vector<byte>& seed) {
-  std::copy_n(seed.begin(), 64, this->seed_.begin());
+  if (fresh && cache_) {
+    cache_->insert(indices, *parent);
+  }
+  return parent->node();
 }
 
-HDWallet::HDWallet(const SeedData& seed)
-    :seed_(seed) {}
-
-const std::array<byte, 64>& HDWallet::getSeed() const { return this->seed_; }
-
 PrivateKey HDWallet::getRootKey() const {
-  auto root = get_root_node(*this);
+  auto root = deriveNode(DerivationPath{});
   return PrivateKey(root.privateKey());
 }
 
 PrivateKey HDWallet::getKey(const DerivationPath& path) const {
-  const auto node = get_node(*this, path);
+  const auto node = deriveNode(path);
   return PrivateKey(node.privateKey());
 }
 
+tron::TronAddress HDWallet::getTronAddress(const DerivationPath& path) const {
+  auto node = deriveNode(path);
+  return tron::TronAddress::derive_from_point(node.publicKeyPoint());
+}
+
 std::string HDWallet::getExtendedPrivateKeyAccount(uint32_t coin,
                                                    uint32_t account) const {
   const auto path = DerivationPath{{
       DerivationPathIndex{PURPOSE_BIP44, true},
       DerivationPathIndex{coin, true},
   }};
-  auto node = get_node(*this, path);
-  auto fingerprintValue = node_fingerprint(node);
+  auto node = deriveNode(path);
+  auto fingerprintValue = node.fingerprint();
   node = node.privateCkd(account + 0x80000000);
-  return node_serialize(node, fingerprintValue, false);
+  return node.serialize(fingerprintValue, false);
 }
 
 std::string HDWallet::getExtendedPublicKeyAccount(uint32_t coin,
@@ -159,27 +116,34 @@ std::string HDWallet::getExtendedPublicKeyAccount(uint32_t coin,
       DerivationPathIndex{PURPOSE_BIP44, true},
       DerivationPathIndex{coin, true},
   }};
-  auto node = get_node(*this, path);
-  auto fingerprintValue = node_fingerprint(node);
+  auto node = deriveNode(path);
+  auto fingerprintValue = node.fingerprint();
   node = node.privateCkd(account + 0x80000000);
   node.fillPublicKey();
-  return node_serialize(node, fingerprintValue, true);
+  return node.serialize(fingerprintValue, true);
 }
 PublicKey HDWallet::getPublicKeyFromExtended(const std::string& extended,
                                              const DerivationPath& path) {
-  HDNode node = {};
-  node_deserialize(extended, &node);
-  node = node.publicCkd(path.change());
-  node = node.publicCkd(path.address());
-  node.fillPublicKey();
-  return PublicKey{node.publicKey()};
+  return ExtendedKey::parse(extended).derivePublicKey(path);
+}
+tron::TronAddress HDWallet::getTronAddressFromExtended(
+    const std::string& extended, const DerivationPath& path) {
+  return ExtendedKey::parse(extended).deriveTronAddress(path);
 }
+
+void HDWallet::deriveRange(const std::string& extended, uint32_t change,
+                           uint32_t start, std::span<PublicKey::KeyData> out) {
+  ExtendedKey::parse(extended).deriveRange(change, start, out);
+}
+
+void HDWallet::deriveTronAddressRange(const std::string& extended,
+                                      uint32_t change, uint32_t start,
+                                      std::span<tron::TronAddress::Data> out) {
+  ExtendedKey::parse(extended).deriveTronAddressRange(change, start, out);
+}
+
 PrivateKey HDWallet::getPrivateKeyFromExtended(const std::string& extended,
                                                const DerivationPath& path) {
-  HDNode node = {};
-  node_deserialize(extended, &node);
-  node = node.privateCkd(path.change());
-  node = node.privateCkd(path.address());
-  return PrivateKey{node.privateKey()};
+  return ExtendedKey::parse(extended).derivePrivateKey(path);
 }
 }  // namespace wallet
@@ -1,74 +1,207 @@
 ﻿#include "keccak.h"
 
-int LFSR86540(u8 *R) { (*R) = ((*R) << 1) ^ (((*R) & 0x80) ? 0x71 : 0); return ((*R) & 2) >> 1; }
+#include <string.h>
+
 #define ROL(a, o) ((((u64)(a)) << (o)) ^ (((u64)(a)) >> (64 - (o))))
+
+// 预先计算的 24 轮 ι 常量
+static const u64 RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
 static u64 load64(const u8 *x) { ui i; u64 u = 0; FOR(i, 8) { u <<= 8; u |= x[7 - i]; } return u; }
 static void store64(u8 *x, u64 u) { ui i; FOR(i, 8) { x[i] = u; u >>= 8; } }
-static void xor64(u8 *x, u64 u) { ui i; FOR(i, 8) { x[i] ^= u; u >>= 8; } }
-
-#define rL(x, y) load64((u8 *)s + 8 * ((x) + 5 * (y)))
-#define wL(x, y, l) store64((u8 *)s + 8 * ((x) + 5 * (y)), (l))
-#define XL(x, y, l) xor64((u8 *)s + 8 * ((x) + 5 * (y)), (l))
-
-void KeccakF1600(void *s) {
-    ui r, x, y, i, j, Y; u8 R = 0x01; u64 C[5], D;
-    for (i = 0; i < 24; i++) {
-        /* θ */
-        FOR(x, 5) C[x] = rL(x, 0) ^ rL(x, 1) ^ rL(x, 2) ^ rL(x, 3) ^ rL(x, 4);
-        FOR(x, 5) {
-            D = C[(x + 4) % 5] ^ ROL(C[(x + 1) % 5], 1);
-            FOR(y, 5) XL(x, y, D);
-        }
-        /* ρπ */
-        x = 1; y = r = 0; D = rL(x, y);
-        FOR(j, 24) {
-            r += j + 1;
-            Y = (2 * x + 3 * y) % 5;
-            x = y;
-            y = Y;
-            C[0] = rL(x, y);
-            wL(x, y, ROL(D, r % 64));
-            D = C[0];
-        }
-        /* χ */
-        FOR(y, 5) {
-            FOR(x, 5) C[x] = rL(x, y);
-            FOR(x, 5) wL(x, y, C[x] ^ ((~C[(x + 1) % 5]) & C[(x + 2) % 5]));
-        }
-        /* ι */
-        FOR(j, 7) if (LFSR86540(&R)) XL(0, 0, (u64)1 << ((1 << j) - 1));
-    }
+
+// 一轮 θ ρ π χ ι，lane Axy 对应状态中的 s[x + 5 * y]
+#define KECCAK_ROUND(rc) \
+    do { \
+        C0 = A00 ^ A01 ^ A02 ^ A03 ^ A04; \
+        C1 = A10 ^ A11 ^ A12 ^ A13 ^ A14; \
+        C2 = A20 ^ A21 ^ A22 ^ A23 ^ A24; \
+        C3 = A30 ^ A31 ^ A32 ^ A33 ^ A34; \
+        C4 = A40 ^ A41 ^ A42 ^ A43 ^ A44; \
+        D0 = C4 ^ ROL(C1, 1); \
+        D1 = C0 ^ ROL(C2, 1); \
+        D2 = C1 ^ ROL(C3, 1); \
+        D3 = C2 ^ ROL(C4, 1); \
+        D4 = C3 ^ ROL(C0, 1); \
+        B00 = A00 ^ D0; \
+        B02 = ROL(A10 ^ D1, 1); \
+        B04 = ROL(A20 ^ D2, 62); \
+        B01 = ROL(A30 ^ D3, 28); \
+        B03 = ROL(A40 ^ D4, 27); \
+        B13 = ROL(A01 ^ D0, 36); \
+        B10 = ROL(A11 ^ D1, 44); \
+        B12 = ROL(A21 ^ D2, 6); \
+        B14 = ROL(A31 ^ D3, 55); \
+        B11 = ROL(A41 ^ D4, 20); \
+        B21 = ROL(A02 ^ D0, 3); \
+        B23 = ROL(A12 ^ D1, 10); \
+        B20 = ROL(A22 ^ D2, 43); \
+        B22 = ROL(A32 ^ D3, 25); \
+        B24 = ROL(A42 ^ D4, 39); \
+        B34 = ROL(A03 ^ D0, 41); \
+        B31 = ROL(A13 ^ D1, 45); \
+        B33 = ROL(A23 ^ D2, 15); \
+        B30 = ROL(A33 ^ D3, 21); \
+        B32 = ROL(A43 ^ D4, 8); \
+        B42 = ROL(A04 ^ D0, 18); \
+        B44 = ROL(A14 ^ D1, 2); \
+        B41 = ROL(A24 ^ D2, 61); \
+        B43 = ROL(A34 ^ D3, 56); \
+        B40 = ROL(A44 ^ D4, 14); \
+        A00 = B00 ^ (~B10 & B20); \
+        A10 = B10 ^ (~B20 & B30); \
+        A20 = B20 ^ (~B30 & B40); \
+        A30 = B30 ^ (~B40 & B00); \
+        A40 = B40 ^ (~B00 & B10); \
+        A01 = B01 ^ (~B11 & B21); \
+        A11 = B11 ^ (~B21 & B31); \
+        A21 = B21 ^ (~B31 & B41); \
+        A31 = B31 ^ (~B41 & B01); \
+        A41 = B41 ^ (~B01 & B11); \
+        A02 = B02 ^ (~B12 & B22); \
+        A12 = B12 ^ (~B22 & B32); \
+        A22 = B22 ^ (~B32 & B42); \
+        A32 = B32 ^ (~B42 & B02); \
+        A42 = B42 ^ (~B02 & B12); \
+        A03 = B03 ^ (~B13 & B23); \
+        A13 = B13 ^ (~B23 & B33); \
+        A23 = B23 ^ (~B33 & B43); \
+        A33 = B33 ^ (~B43 & B03); \
+        A43 = B43 ^ (~B03 & B13); \
+        A04 = B04 ^ (~B14 & B24); \
+        A14 = B14 ^ (~B24 & B34); \
+        A24 = B24 ^ (~B34 & B44); \
+        A34 = B34 ^ (~B44 & B04); \
+        A44 = B44 ^ (~B04 & B14); \
+        A00 ^= (rc); \
+    } while (0)
+
+static void KeccakF1600(u64 *s) {
+    u64 A00, A10, A20, A30, A40, A01, A11, A21, A31, A41, A02, A12, A22, A32, A42, A03, A13, A23, A33, A43, A04, A14, A24, A34, A44;
+    u64 B00, B10, B20, B30, B40, B01, B11, B21, B31, B41, B02, B12, B22, B32, B42, B03, B13, B23, B33, B43, B04, B14, B24, B34, B44;
+    u64 C0, C1, C2, C3, C4, D0, D1, D2, D3, D4;
+    A00 = s[0];
+    A10 = s[1];
+    A20 = s[2];
+    A30 = s[3];
+    A40 = s[4];
+    A01 = s[5];
+    A11 = s[6];
+    A21 = s[7];
+    A31 = s[8];
+    A41 = s[9];
+    A02 = s[10];
+    A12 = s[11];
+    A22 = s[12];
+    A32 = s[13];
+    A42 = s[14];
+    A03 = s[15];
+    A13 = s[16];
+    A23 = s[17];
+    A33 = s[18];
+    A43 = s[19];
+    A04 = s[20];
+    A14 = s[21];
+    A24 = s[22];
+    A34 = s[23];
+    A44 = s[24];
+    KECCAK_ROUND(RC[0]);
+    KECCAK_ROUND(RC[1]);
+    KECCAK_ROUND(RC[2]);
+    KECCAK_ROUND(RC[3]);
+    KECCAK_ROUND(RC[4]);
+    KECCAK_ROUND(RC[5]);
+    KECCAK_ROUND(RC[6]);
+    KECCAK_ROUND(RC[7]);
+    KECCAK_ROUND(RC[8]);
+    KECCAK_ROUND(RC[9]);
+    KECCAK_ROUND(RC[10]);
+    KECCAK_ROUND(RC[11]);
+    KECCAK_ROUND(RC[12]);
+    KECCAK_ROUND(RC[13]);
+    KECCAK_ROUND(RC[14]);
+    KECCAK_ROUND(RC[15]);
+    KECCAK_ROUND(RC[16]);
+    KECCAK_ROUND(RC[17]);
+    KECCAK_ROUND(RC[18]);
+    KECCAK_ROUND(RC[19]);
+    KECCAK_ROUND(RC[20]);
+    KECCAK_ROUND(RC[21]);
+    KECCAK_ROUND(RC[22]);
+    KECCAK_ROUND(RC[23]);
+    s[0] = A00;
+    s[1] = A10;
+    s[2] = A20;
+    s[3] = A30;
+    s[4] = A40;
+    s[5] = A01;
+    s[6] = A11;
+    s[7] = A21;
+    s[8] = A31;
+    s[9] = A41;
+    s[10] = A02;
+    s[11] = A12;
+    s[12] = A22;
+    s[13] = A32;
+    s[14] = A42;
+    s[15] = A03;
+    s[16] = A13;
+    s[17] = A23;
+    s[18] = A33;
+    s[19] = A43;
+    s[20] = A04;
+    s[21] = A14;
+    s[22] = A24;
+    s[23] = A34;
+    s[24] = A44;
 }
 
+// r 必须是 64 的倍数（所有标准参数均满足）
 void Keccak(ui r, ui c, const u8 *in, u64 inLen, u8 sfx, u8 *out, u64 outLen) {
-    u8 s[200];
+    u64 s[25];
+    u8 block[200];
     ui R = r / 8;
-    ui i, b = 0;
-    FOR(i, 200) s[i] = 0;
+    ui i, b;
+    (void)c;
+    FOR(i, 25) s[i] = 0;
 
     // absorb
-    while (inLen > 0) {
-        b = (inLen < R) ? inLen : R;
-        FOR(i, b) s[i] ^= in[i];
-        in += b;
-        inLen -= b;
-        if (b == R) {
-            KeccakF1600(s);
-            b = 0;
-        }
+    while (inLen >= R) {
+        FOR(i, R / 8) s[i] ^= load64(in + 8 * i);
+        KeccakF1600(s);
+        in += R;
+        inLen -= R;
     }
 
     // padding
-    s[b] ^= sfx;
-    if ((sfx & 0x80) && (b == (R - 1)))
+    b = (ui)inLen;
+    memset(block, 0, R);
+    memcpy(block, in, b);
+    block[b] ^= sfx;
+    if ((sfx & 0x80) && (b == (R - 1))) {
+        FOR(i, R / 8) s[i] ^= load64(block + 8 * i);
         KeccakF1600(s);
-    s[R - 1] ^= 0x80;
+        memset(block, 0, R);
+    }
+    block[R - 1] ^= 0x80;
+    FOR(i, R / 8) s[i] ^= load64(block + 8 * i);
     KeccakF1600(s);
 
     // squeeze
     while (outLen > 0) {
-        b = (outLen < R) ? outLen : R;
-        FOR(i, b) out[i] = s[i];
+        b = (outLen < R) ? (ui)outLen : R;
+        FOR(i, b / 8) store64(out + 8 * i, s[i]);
+        if (b % 8) {
+            store64(block, s[b / 8]);
+            memcpy(out + b - b % 8, block, b % 8);
+        }
         out += b;
         outLen -= b;
         if (outLen > 0)
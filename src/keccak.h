@@ -33,6 +33,10 @@ static inline void Keccak256(const u8 *in, u64 inLen, u8 *out) {
     Keccak(1088, 512, in, inLen, 0x01, out, 32);
 }
 
+// 批量 Keccak-256：n 个独立的 64 字节输入（如非压缩公钥去掉前缀），
+// in 为 n * 64 字节，out 为 n * 32 字节；运行时按 CPU 选择 AVX-512 / AVX2 多路实现
+void Keccak256_xN(const u8 *in, size_t n, u8 *out);
+
 #ifdef __cplusplus
 }
 #endif
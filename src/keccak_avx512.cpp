@@ -0,0 +1,132 @@
+#ifdef ENABLE_AVX512
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+namespace keccak_avx512 {
+namespace {
+
+const uint64_t RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+__m512i inline K(uint64_t x) { return _mm512_set1_epi64(x); }
+__m512i inline Xor(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+/** Three-input xor in a single ternary-logic instruction. */
+__m512i inline Xor3(__m512i a, __m512i b, __m512i c) { return _mm512_ternarylogic_epi64(a, b, c, 0x96); }
+__m512i inline Xor5(__m512i a, __m512i b, __m512i c, __m512i d, __m512i e) { return Xor3(Xor3(a, b, c), d, e); }
+template <int n> __m512i inline RotL(__m512i x) { return _mm512_rol_epi64(x, n); }
+/** a ^ (~b & c) */
+__m512i inline Chi(__m512i a, __m512i b, __m512i c) { return _mm512_ternarylogic_epi64(a, b, c, 0xd2); }
+
+/** Word i of each lane's message, little-endian. */
+__m512i inline Read(const unsigned char* in, int i)
+{
+    return _mm512_set_epi64(ReadLE64(in + 448 + 8 * i), ReadLE64(in + 384 + 8 * i),
+                            ReadLE64(in + 320 + 8 * i), ReadLE64(in + 256 + 8 * i),
+                            ReadLE64(in + 192 + 8 * i), ReadLE64(in + 128 + 8 * i),
+                            ReadLE64(in + 64 + 8 * i), ReadLE64(in + 8 * i));
+}
+
+} // namespace
+
+/** Keccak-256 of 8 independent 64-byte messages: in holds 8 consecutive
+ *  messages and out receives 8 consecutive 32-byte digests. */
+void Keccak256_8way(const unsigned char* in, unsigned char* out)
+{
+    __m512i A[25], B[25], C[5], D[5];
+    // 64 字节消息只占一个 136 字节的块：8 个消息 lane，随后是填充
+    for (int i = 0; i < 8; ++i) {
+        A[i] = Read(in, i);
+    }
+    A[8] = K(0x01);
+    for (int i = 9; i < 25; ++i) {
+        A[i] = K(0);
+    }
+    A[16] = K(0x8000000000000000ULL);
+
+    for (int round = 0; round < 24; ++round) {
+        C[0] = Xor5(A[0], A[5], A[10], A[15], A[20]);
+        C[1] = Xor5(A[1], A[6], A[11], A[16], A[21]);
+        C[2] = Xor5(A[2], A[7], A[12], A[17], A[22]);
+        C[3] = Xor5(A[3], A[8], A[13], A[18], A[23]);
+        C[4] = Xor5(A[4], A[9], A[14], A[19], A[24]);
+        D[0] = Xor(C[4], RotL<1>(C[1]));
+        D[1] = Xor(C[0], RotL<1>(C[2]));
+        D[2] = Xor(C[1], RotL<1>(C[3]));
+        D[3] = Xor(C[2], RotL<1>(C[4]));
+        D[4] = Xor(C[3], RotL<1>(C[0]));
+        B[0] = Xor(A[0], D[0]);
+        B[10] = RotL<1>(Xor(A[1], D[1]));
+        B[20] = RotL<62>(Xor(A[2], D[2]));
+        B[5] = RotL<28>(Xor(A[3], D[3]));
+        B[15] = RotL<27>(Xor(A[4], D[4]));
+        B[16] = RotL<36>(Xor(A[5], D[0]));
+        B[1] = RotL<44>(Xor(A[6], D[1]));
+        B[11] = RotL<6>(Xor(A[7], D[2]));
+        B[21] = RotL<55>(Xor(A[8], D[3]));
+        B[6] = RotL<20>(Xor(A[9], D[4]));
+        B[7] = RotL<3>(Xor(A[10], D[0]));
+        B[17] = RotL<10>(Xor(A[11], D[1]));
+        B[2] = RotL<43>(Xor(A[12], D[2]));
+        B[12] = RotL<25>(Xor(A[13], D[3]));
+        B[22] = RotL<39>(Xor(A[14], D[4]));
+        B[23] = RotL<41>(Xor(A[15], D[0]));
+        B[8] = RotL<45>(Xor(A[16], D[1]));
+        B[18] = RotL<15>(Xor(A[17], D[2]));
+        B[3] = RotL<21>(Xor(A[18], D[3]));
+        B[13] = RotL<8>(Xor(A[19], D[4]));
+        B[14] = RotL<18>(Xor(A[20], D[0]));
+        B[24] = RotL<2>(Xor(A[21], D[1]));
+        B[9] = RotL<61>(Xor(A[22], D[2]));
+        B[19] = RotL<56>(Xor(A[23], D[3]));
+        B[4] = RotL<14>(Xor(A[24], D[4]));
+        A[0] = Chi(B[0], B[1], B[2]);
+        A[1] = Chi(B[1], B[2], B[3]);
+        A[2] = Chi(B[2], B[3], B[4]);
+        A[3] = Chi(B[3], B[4], B[0]);
+        A[4] = Chi(B[4], B[0], B[1]);
+        A[5] = Chi(B[5], B[6], B[7]);
+        A[6] = Chi(B[6], B[7], B[8]);
+        A[7] = Chi(B[7], B[8], B[9]);
+        A[8] = Chi(B[8], B[9], B[5]);
+        A[9] = Chi(B[9], B[5], B[6]);
+        A[10] = Chi(B[10], B[11], B[12]);
+        A[11] = Chi(B[11], B[12], B[13]);
+        A[12] = Chi(B[12], B[13], B[14]);
+        A[13] = Chi(B[13], B[14], B[10]);
+        A[14] = Chi(B[14], B[10], B[11]);
+        A[15] = Chi(B[15], B[16], B[17]);
+        A[16] = Chi(B[16], B[17], B[18]);
+        A[17] = Chi(B[17], B[18], B[19]);
+        A[18] = Chi(B[18], B[19], B[15]);
+        A[19] = Chi(B[19], B[15], B[16]);
+        A[20] = Chi(B[20], B[21], B[22]);
+        A[21] = Chi(B[21], B[22], B[23]);
+        A[22] = Chi(B[22], B[23], B[24]);
+        A[23] = Chi(B[23], B[24], B[20]);
+        A[24] = Chi(B[24], B[20], B[21]);
+        A[0] = Xor(A[0], K(RC[round]));
+    }
+
+    alignas(64) uint64_t words[4][8];
+    for (int i = 0; i < 4; ++i) {
+        _mm512_store_si512((__m512i*)words[i], A[i]);
+    }
+    for (int lane = 0; lane < 8; ++lane) {
+        for (int i = 0; i < 4; ++i) {
+            WriteLE64(out + 32 * lane + 8 * i, words[i][lane]);
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include "keccak.h"
+
+#if defined(ENABLE_AVX2) || defined(ENABLE_AVX512)
+#include "compat/cpuid.h"
+#endif
+
+namespace keccak_avx2 {
+void Keccak256_4way(const unsigned char* in, unsigned char* out);
+}
+
+namespace keccak_avx512 {
+void Keccak256_8way(const unsigned char* in, unsigned char* out);
+}
+
+namespace {
+using TransformType = void (*)(const unsigned char*, unsigned char*);
+
+TransformType keccak256_4way = nullptr;
+TransformType keccak256_8way = nullptr;
+
+#if defined(ENABLE_AVX2) || defined(ENABLE_AVX512)
+#if defined(HAVE_GETCPUID)
+uint32_t XCR0() {
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return a;
+}
+#endif
+#endif
+
+bool AutoDetect() {
+#if defined(ENABLE_AVX2) || defined(ENABLE_AVX512)
+#if defined(HAVE_GETCPUID)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    const uint32_t xcr0 = have_xsave && have_avx ? XCR0() : 0;
+    GetCPUID(0, 0, eax, ebx, ecx, edx);
+    if (eax < 7) {
+        return true;
+    }
+    GetCPUID(7, 0, eax, ebx, ecx, edx);
+#if defined(ENABLE_AVX2)
+    if (((ebx >> 5) & 1) && (xcr0 & 0x06) == 0x06) {
+        keccak256_4way = keccak_avx2::Keccak256_4way;
+    }
+#endif
+#if defined(ENABLE_AVX512)
+    if (((ebx >> 16) & 1) && (xcr0 & 0xe6) == 0xe6) {
+        keccak256_8way = keccak_avx512::Keccak256_8way;
+    }
+#endif
+#endif
+#endif
+    return true;
+}
+
+// 检测完成之前只使用标量实现
+[[maybe_unused]] const bool detected = AutoDetect();
+}  // namespace
+
+extern "C" void Keccak256_xN(const u8* in, size_t n, u8* out) {
+    if (keccak256_8way) {
+        for (; n >= 8; n -= 8, in += 8 * 64, out += 8 * 32) {
+            keccak256_8way(in, out);
+        }
+    }
+    if (keccak256_4way) {
+        for (; n >= 4; n -= 4, in += 4 * 64, out += 4 * 32) {
+            keccak256_4way(in, out);
+        }
+    }
+    for (; n > 0; --n, in += 64, out += 32) {
+        Keccak256(in, 64, out);
+    }
+}
@@ -0,0 +1,108 @@
+#include "node_cache.h"
+
+#include "support/cleanse.h"
+
+using namespace wallet;
+
+NodeCache::NodeCache(size_t capacity) : capacity_(capacity < 1 ? 1 : capacity) {}
+
+NodeCache::~NodeCache() { clear(); }
+
+std::pair<NodeCache::Entry*, size_t> NodeCache::find(
+    std::span<const DerivationPathIndex> path) const {
+    Entry* entry = root_;
+    size_t depth = 0;
+    for (const auto& index : path) {
+        auto it = entry->children.find(index.derivationIndex());
+        if (it == entry->children.end()) {
+            break;
+        }
+        entry = it->second;
+        ++depth;
+    }
+    return {entry, depth};
+}
+
+void NodeCache::touch(Entry* entry) {
+    // Splicing the deepest entry first leaves every ancestor in front of its
+    // descendants, so the back of the list is always a leaf.
+    for (; entry != nullptr; entry = entry->parent) {
+        entries_.splice(entries_.begin(), entries_, entry->pos);
+    }
+}
+
+std::optional<size_t> NodeCache::lookup(std::span<const DerivationPathIndex> path,
+                                        std::optional<CkdContext>& ckd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (root_ == nullptr) {
+        return std::nullopt;
+    }
+    auto [entry, depth] = find(path);
+    touch(entry);
+    ckd.emplace(entry->ckd);
+    return depth;
+}
+
+void NodeCache::insert(std::span<const DerivationPathIndex> path, const CkdContext& ckd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* parent = nullptr;
+    uint32_t index = 0;
+    if (path.empty()) {
+        if (root_ != nullptr) {
+            return;
+        }
+    } else {
+        if (root_ == nullptr) {
+            return;
+        }
+        auto [entry, depth] = find(path.first(path.size() - 1));
+        if (depth != path.size() - 1) {
+            return;
+        }
+        index = path.back().derivationIndex();
+        if (entry->children.count(index) != 0) {
+            return;
+        }
+        parent = entry;
+    }
+
+    auto& inserted = entries_.emplace_front(Entry{ckd, index, parent, {}, {}});
+    inserted.pos = entries_.begin();
+    if (parent != nullptr) {
+        parent->children.emplace(index, &inserted);
+        touch(parent);
+    } else {
+        root_ = &inserted;
+    }
+    while (entries_.size() > capacity_ && evict()) {
+    }
+}
+
+bool NodeCache::evict() {
+    auto& victim = entries_.back();
+    if (!victim.children.empty()) {
+        return false;
+    }
+    if (victim.parent != nullptr) {
+        victim.parent->children.erase(victim.index);
+    } else {
+        root_ = nullptr;
+    }
+    memory_cleanse(&victim.ckd, sizeof(victim.ckd));
+    entries_.pop_back();
+    return true;
+}
+
+void NodeCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+        memory_cleanse(&entry.ckd, sizeof(entry.ckd));
+    }
+    entries_.clear();
+    root_ = nullptr;
+}
+
+size_t NodeCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
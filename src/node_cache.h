@@ -0,0 +1,80 @@
+#ifndef WALLET_NODE_CACHE_H
+#define WALLET_NODE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+#include "bip32.h"
+#include "wallet_core/derivation_path.h"
+
+namespace wallet {
+
+/// Bounded cache of derived nodes, organized as a trie keyed by path prefix.
+///
+/// Nodes are stored as their `CkdContext`, so deriving a child of a cached
+/// node skips the HMAC key setup as well. The trie root holds the master
+/// node, and each entry below it is keyed by the child index under its
+/// parent, so the entry at depth n holds the node for the first n components
+/// of a path. Entries are kept in LRU order with
+/// every ancestor more recently used than its descendants, which means the
+/// least recently used entry is always a leaf and can be evicted without
+/// orphaning anything. Evicted nodes are wiped before their memory is freed.
+///
+/// All methods are safe to call concurrently.
+class NodeCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    explicit NodeCache(size_t capacity = DEFAULT_CAPACITY);
+    NodeCache(const NodeCache&) = delete;
+    NodeCache& operator=(const NodeCache&) = delete;
+    ~NodeCache();
+
+    /// Copies the context for the longest cached prefix of `path` into `ckd`.
+    ///
+    /// \returns the number of components of `path` the copied node covers, or
+    /// `std::nullopt` if not even the master node is cached.
+    std::optional<size_t> lookup(std::span<const DerivationPathIndex> path,
+                                 std::optional<CkdContext>& ckd);
+
+    /// Caches `ckd` as the context for `path`. The entry for `path` without
+    /// its last component must already be cached, otherwise this is a no-op.
+    void insert(std::span<const DerivationPathIndex> path, const CkdContext& ckd);
+
+    /// Wipes and drops every cached node.
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        CkdContext ckd;
+        uint32_t index;
+        Entry* parent;
+        std::unordered_map<uint32_t, Entry*> children;
+        std::list<Entry>::iterator pos;
+    };
+
+    /// Walks `path` from the root and returns the deepest matching entry
+    /// along with the number of components it covers.
+    std::pair<Entry*, size_t> find(std::span<const DerivationPathIndex> path) const;
+    /// Moves `entry` and all of its ancestors to the front of the LRU list,
+    /// ancestors first.
+    void touch(Entry* entry);
+    /// Wipes and drops the least recently used entry if it is a leaf.
+    bool evict();
+
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_;
+    Entry* root_ = nullptr;
+};
+
+}  // namespace wallet
+
+#endif  // WALLET_NODE_CACHE_H
@@ -26,6 +26,14 @@ PublicKey PrivateKey::getPublicKey() const {
     return PublicKey {pub_data};
 }
 
+PrivateKey::Signature PrivateKey::signRecoverable(std::span<const byte, 32> hash) const {
+    Signature sig;
+    if (!sign_recoverable(get_secp256k1_context(), data_.data(), hash.data(), sig.data())) {
+        throw std::runtime_error("Failed to sign");
+    }
+    return sig;
+}
+
 const PrivateKey::KeyData& PrivateKey::data() const{
     return data_;
 }
@@ -1,4 +1,5 @@
 #include "wallet_core/public_key.h"
+#include <algorithm>
 #include <stdexcept>
 #include "curve.h"
 
@@ -0,0 +1,47 @@
+#include "random.h"
+
+#include <cerrno>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <bcrypt.h>
+#elif defined(__linux__)
+#include <sys/random.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace wallet {
+
+void GetOSRand(std::span<unsigned char> out) {
+#if defined(_WIN32)
+    if (BCryptGenRandom(nullptr, out.data(), static_cast<ULONG>(out.size()),
+                        BCRYPT_USE_SYSTEM_PREFERRED_RNG) != 0) {
+        throw std::runtime_error("BCryptGenRandom failed");
+    }
+#elif defined(__linux__)
+    size_t done = 0;
+    while (done < out.size()) {
+        const ssize_t n = getrandom(out.data() + done, out.size() - done, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("getrandom failed");
+        }
+        done += static_cast<size_t>(n);
+    }
+#else
+    // getentropy 每次最多 256 字节
+    for (size_t done = 0; done < out.size(); done += 256) {
+        const size_t n = std::min<size_t>(256, out.size() - done);
+        if (getentropy(out.data() + done, n) != 0) {
+            throw std::runtime_error("getentropy failed");
+        }
+    }
+#endif
+}
+
+}  // namespace wallet
@@ -0,0 +1,15 @@
+#ifndef WALLET_RANDOM_H
+#define WALLET_RANDOM_H
+
+#include <span>
+
+namespace wallet {
+
+/// Fills `out` with bytes from the operating system's CSPRNG.
+///
+/// \throws std::runtime_error if the operating system cannot provide them.
+void GetOSRand(std::span<unsigned char> out);
+
+}  // namespace wallet
+
+#endif  // WALLET_RANDOM_H
@@ -9,7 +9,7 @@
 #include "attributes.h"
 #include "compat/assumptions.h" // IWYU pragma: keep
 #include "compat/endian.h"
-#include "prevector.h"
+#include "wallet_core/prevector.h"
 #include "span.h"
 
 #include <algorithm>
@@ -0,0 +1,158 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+using namespace wallet;
+
+namespace {
+struct CurrentWorker {
+    const ThreadPool* pool = nullptr;
+    size_t index = 0;
+};
+thread_local CurrentWorker current_worker;
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        stop_ = true;
+    }
+    wait_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::currentWorker() const {
+    return current_worker.pool == this ? current_worker.index : workers_.size();
+}
+
+void ThreadPool::push(size_t worker, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(workers_[worker]->mutex);
+        workers_[worker]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        ++queued_;
+    }
+    wait_cv_.notify_one();
+}
+
+void ThreadPool::submit(Task task) {
+    size_t worker = currentWorker();
+    if (worker == size()) {
+        worker = next_worker_++ % size();
+    }
+    push(worker, std::move(task));
+}
+
+bool ThreadPool::runPending(size_t self) {
+    const size_t n = workers_.size();
+    Task task;
+    if (self < n) {
+        auto& own = *workers_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    for (size_t i = 1; !task && i <= n; ++i) {
+        auto& victim = *workers_[(self + i) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    --queued_;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    current_worker = {this, index};
+    for (;;) {
+        if (runPending(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        wait_cv_.wait(lock, [this] { return stop_ || queued_ > 0; });
+        if (stop_ && queued_ == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1) {
+        fn(0, count);
+        return;
+    }
+
+    struct Job {
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+    auto job = std::make_shared<Job>();
+    job->remaining = chunks;
+
+    const size_t self = currentWorker();
+    const size_t first = self < size() ? self : next_worker_++;
+    for (size_t c = 0; c < chunks; ++c) {
+        const size_t begin = c * grain;
+        const size_t end = std::min(count, begin + grain);
+        push((first + c) % size(), [job, &fn, begin, end] {
+            try {
+                fn(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                if (!job->error) {
+                    job->error = std::current_exception();
+                }
+            }
+            if (job->remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->done.notify_all();
+            }
+        });
+    }
+
+    while (job->remaining.load() != 0) {
+        if (runPending(self)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->done.wait(lock, [&] { return job->remaining.load() == 0; });
+    }
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef WALLET_THREAD_POOL_H
+#define WALLET_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wallet {
+
+/// Fixed-size pool of worker threads with one task deque per worker.
+///
+/// A worker runs tasks from the back of its own deque and, once that is
+/// empty, steals from the front of the other workers' deques, so a job split
+/// into many chunks stays balanced without a shared central queue. Threads
+/// waiting in `parallelFor` run queued tasks themselves instead of blocking,
+/// which also makes nested `parallelFor` calls from inside a task safe.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /// Starts `threads` workers; 0 means one per hardware thread.
+    explicit ThreadPool(size_t threads = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    /// Runs every queued task, then joins the workers.
+    ~ThreadPool();
+
+    size_t size() const { return workers_.size(); }
+
+    /// Queues `task` to run on some worker. Tasks must not throw.
+    void submit(Task task);
+
+    /// Calls `fn(begin, end)` for consecutive chunks of at most `grain`
+    /// elements covering `[0, count)` and waits until all of them finish.
+    ///
+    /// \throws the first exception thrown by any chunk, after every chunk has
+    /// finished.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    /// Index of the calling thread among this pool's workers, or `size()` if
+    /// it is not one of them.
+    size_t currentWorker() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(size_t worker, Task task);
+    /// Pops a task from `self`'s deque or steals one from another worker and
+    /// runs it. Returns false if every deque was empty.
+    bool runPending(size_t self);
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> next_worker_{0};
+    bool stop_ = false;
+};
+
+}  // namespace wallet
+
+#endif  // WALLET_THREAD_POOL_H
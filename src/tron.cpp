@@ -1,5 +1,13 @@
 #include "wallet_core/tron.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "wallet_core/private_key.h"
 #include "wallet_core/public_key.h"
+#include "curve.h"
+#include "curve_batch.h"
 #include "keccak.h"
 #include "crypto/hex_base.h"
 #include "base58.h"
@@ -10,20 +18,167 @@ TronAddress::TronAddress(const TronAddress::Data& data) : data_(data) {
 
 }
 
+const TronAddress::Data& TronAddress::data() const {
+    return data_;
+}
+
 std::string TronAddress::string() {
-    return EncodeBase58Check(data_);
+    char buf[BASE58CHECK_21_MAX_SIZE];
+    return std::string(buf, EncodeBase58Check(data_, buf));
+}
+
+void TronAddress::string(std::span<char, STRING_SIZE> out) const {
+    char buf[BASE58CHECK_21_MAX_SIZE];
+    if (EncodeBase58Check(data_, buf) != STRING_SIZE) {
+        throw std::runtime_error("Not a Tron address");
+    }
+    std::copy_n(buf, STRING_SIZE, out.begin());
 }
 std::string TronAddress::hex() {
     return HexStr(data_);
 }
 
+namespace {
+// 地址必须是 0x41 前缀的 21 字节
+bool decode_address(std::string_view str, TronAddress::Data& data) {
+    return DecodeBase58Check(str, data) && data[0] == 0x41;
+}
+}  // namespace
+
+TronAddress TronAddress::from_string(std::string_view str) {
+    Data data;
+    if (!decode_address(str, data)) {
+        throw std::invalid_argument("Invalid Tron address");
+    }
+    return TronAddress(data);
+}
+
+bool TronAddress::is_valid(std::string_view str) {
+    Data data;
+    return decode_address(str, data);
+}
+
+void TronAddress::to_strings(std::span<const Data> data,
+                             std::span<std::array<char, STRING_SIZE>> out) {
+    if (data.size() != out.size()) {
+        throw std::invalid_argument("Output size does not match the number of addresses");
+    }
+    static const size_t BATCH = 64;
+    std::array<char, BASE58CHECK_21_MAX_SIZE> buf[BATCH];
+    size_t lengths[BATCH];
+    for (size_t done = 0; done < data.size(); done += BATCH) {
+        const size_t count = std::min(BATCH, data.size() - done);
+        EncodeBase58Check(data.subspan(done, count), std::span(buf, count), std::span(lengths, count));
+        for (size_t i = 0; i < count; ++i) {
+            if (lengths[i] != STRING_SIZE) {
+                throw std::runtime_error("Not a Tron address");
+            }
+            std::copy_n(buf[i].begin(), STRING_SIZE, out[done + i].begin());
+        }
+    }
+}
+
+size_t TronAddress::validate(std::span<const std::string_view> strs,
+                             std::span<Data> out, std::span<bool> valid) {
+    if (strs.size() != out.size() || strs.size() != valid.size()) {
+        throw std::invalid_argument("Output size does not match the number of addresses");
+    }
+    size_t count = DecodeBase58Check(strs, out, valid);
+    for (size_t i = 0; i < strs.size(); ++i) {
+        if (valid[i] && out[i][0] != 0x41) {
+            valid[i] = false;
+            --count;
+        }
+    }
+    return count;
+}
+
 TronAddress TronAddress::derive_from_public_key(const PublicKey& key) {
-    std::vector<byte> pub_key = key.uncompressed();
+    secp256k1_pubkey pubkey;
+    if (!secp256k1_ec_pubkey_parse(get_secp256k1_context(), &pubkey, key.data().data(), key.data().size())) {
+        throw std::runtime_error("Failed to parse public key");
+    }
+    return derive_from_point(pubkey);
+}
+
+TronAddress TronAddress::derive_from_private_key(const PrivateKey& key) {
+    secp256k1_pubkey pubkey;
+    if (!secp256k1_ec_pubkey_create(get_secp256k1_context(), &pubkey, key.data().data())) {
+        throw std::runtime_error("Failed to create public key");
+    }
+    return derive_from_point(pubkey);
+}
+
+TronAddress TronAddress::derive_from_point(const secp256k1_pubkey& key) {
+    // 非压缩公钥直接写入栈上缓冲区，跳过 0x04 前缀后计算 Keccak
+    byte pub_key[65];
+    size_t key_size = sizeof(pub_key);
+    if (!secp256k1_ec_pubkey_serialize(get_secp256k1_context(), pub_key, &key_size, &key,
+                                       SECP256K1_EC_UNCOMPRESSED)) {
+        throw std::runtime_error("Failed to serialize public key");
+    }
     std::array<byte, 32> hash;
-    Keccak256(pub_key.data() +1, 64, hash.data());
+    Keccak256(pub_key + 1, 64, hash.data());
     std::array<uint8_t, 21> addr_bytes{};
     addr_bytes[0] = 0x41;
     std::memcpy(addr_bytes.data() + 1, hash.data() + 12, 20);
     return TronAddress(addr_bytes);
+}
 
-}
\ No newline at end of file
+void TronAddress::derive_from_points(std::span<const secp256k1_pubkey> keys, std::span<Data> out) {
+    if (keys.size() != out.size()) {
+        throw std::invalid_argument("Output size does not match the number of keys");
+    }
+    static const size_t BATCH = 64;
+    auto ctx = get_secp256k1_context();
+    byte points[64 * BATCH];
+    byte hashes[32 * BATCH];
+    for (size_t done = 0; done < keys.size(); done += BATCH) {
+        const size_t count = std::min(BATCH, keys.size() - done);
+        for (size_t i = 0; i < count; ++i) {
+            byte pub_key[65];
+            size_t key_size = sizeof(pub_key);
+            if (!secp256k1_ec_pubkey_serialize(ctx, pub_key, &key_size, &keys[done + i],
+                                               SECP256K1_EC_UNCOMPRESSED)) {
+                throw std::runtime_error("Failed to serialize public key");
+            }
+            std::memcpy(points + 64 * i, pub_key + 1, 64);
+        }
+        Keccak256_xN(points, count, hashes);
+        for (size_t i = 0; i < count; ++i) {
+            auto& addr = out[done + i];
+            addr[0] = 0x41;
+            std::memcpy(addr.data() + 1, hashes + 32 * i + 12, 20);
+        }
+    }
+}
+
+size_t TronAddress::recover_addresses(std::span<const std::array<byte, 65>> sigs,
+                                      std::span<const std::array<byte, 32>> hashes,
+                                      std::span<Data> out, std::span<bool> valid) {
+    if (sigs.size() != hashes.size() || sigs.size() != out.size() || sigs.size() != valid.size()) {
+        throw std::invalid_argument("Output size does not match the number of signatures");
+    }
+    static const size_t BATCH = CURVE_BATCH_SIZE;
+    // 恢复出的坐标直接作为 Keccak 的输入
+    byte points[64 * BATCH];
+    byte hashed[32 * BATCH];
+    unsigned char ok[BATCH];
+    size_t count = 0;
+    for (size_t done = 0; done < sigs.size(); done += BATCH) {
+        const size_t n = std::min(BATCH, sigs.size() - done);
+        count += curve_ecdsa_recover_batch(points, ok, sigs[done].data(), hashes[done].data(), n);
+        Keccak256_xN(points, n, hashed);
+        for (size_t i = 0; i < n; ++i) {
+            auto& addr = out[done + i];
+            valid[done + i] = ok[i] != 0;
+            if (ok[i]) {
+                addr[0] = 0x41;
+                std::memcpy(addr.data() + 1, hashed + 32 * i + 12, 20);
+            } else {
+                addr.fill(0);
+            }
+        }
+    }
+    return count;
+}